@@ -281,6 +281,27 @@ $(BINDIR)/%.$1.o: $(SRCDIR)/%.$1 $(DEPDIR)/$(basename %).d
 endef
 $(foreach cxxext,$(CXXEXTS),$(eval $(call cxx_rule,$(cxxext))))
 
+HOSTBINDIR=$(BINDIR)/host
+HOSTSRC=$(foreach cxxext,$(CXXEXTS),$(call rwildcard, $(HOSTDIR),*.$(cxxext)))
+HOSTOBJ=$(addprefix $(HOSTBINDIR)/,$(patsubst $(HOSTDIR)/%,%.o,$(HOSTSRC)))
+HOST_ELF=$(HOSTBINDIR)/vexlog
+HOST_CXXFLAGS=$(HOST_MFLAGS) -DVEXLOG_HOST $(HOST_CPPFLAGS) $(WARNFLAGS) --std=$(CXX_STANDARD)
+
+.PHONY: host
+host: $(HOST_ELF)
+
+$(HOST_ELF): $(HOSTOBJ)
+	$(call test_output_2,Linking host build ,$(HOSTCXX) $(HOST_MFLAGS) $^ $(HOST_LDLIBS) -o $@,$(OK_STRING))
+
+define host_cxx_rule
+$(HOSTBINDIR)/%.$1.o: $(HOSTDIR)/%.$1
+	$(VV)mkdir -p $$(dir $$@)
+	$$(call test_output_2,Compiled $$< for host ,$(HOSTCXX) -c $(INCLUDE) $(HOST_CXXFLAGS) -MMD -MP -o $$@ $$<,$(OK_STRING))
+endef
+$(foreach cxxext,$(CXXEXTS),$(eval $(call host_cxx_rule,$(cxxext))))
+
+-include $(HOSTOBJ:.o=.d)
+
 define _pros_ld_timestamp
 $(VV)mkdir -p $(dir $(LDTIMEOBJ))
 @# Pipe a line of code defining _PROS_COMPILE_TOOLSTAMP and _PROS_COMPILE_DIRECTORY into GCC,
@@ -0,0 +1,342 @@
+#include "benchmarks.hpp"
+#include "vexlog/float_compression.hpp"
+#include "vexlog/logger.hpp"
+#include "vexlog/pf_logger.hpp"
+#include "vexlog/rans.hpp"
+#include "vexlog/sink.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <unistd.h>
+#include <vector>
+
+namespace benchmarks {
+
+void sinkThroughput() {
+  constexpr size_t frame_size = 10 * 1024;
+  constexpr size_t frames = 20000;
+  std::vector<char> frame(frame_size, 'a');
+
+  // what sendData() used to do: write, then std::endl
+  std::ofstream stream("/dev/null", std::ios::binary);
+  double stream_micros = microsPerCall(frames, [&] {
+    stream.write(frame.data(), frame.size());
+    stream << std::endl;
+  });
+
+  int fd = ::open("/dev/null", O_WRONLY);
+  double fd_micros;
+  {
+    vexmaps::logger::FdSink sink(fd);
+    fd_micros = microsPerCall(frames, [&] {
+      sink.write({frame.data(), frame.size()});
+      sink.flush();
+    });
+  }
+  ::close(fd);
+
+  std::printf("10KB frames to /dev/null: iostream %.2f us (%.0f MB/s), "
+              "FdSink %.2f us (%.0f MB/s)\n",
+              stream_micros, frame_size / stream_micros, fd_micros,
+              frame_size / fd_micros);
+}
+
+void varintWrites() {
+  using vexmaps::logger::LogBuffer;
+  constexpr size_t n = 3072;
+  constexpr size_t iterations = 2000;
+
+  // quantized and delta coded like the x, y and weight arrays of a
+  // VarintParticlesLogger, with the mods the host program picks
+  constexpr int mods[3] = {60, 40, 8256};
+  static float values[3][n];
+  static int16_t quantized[3][n];
+  std::ranlux24_base rng;
+  std::uniform_real_distribution<float> dist(-1.8f, 1.8f);
+  for (size_t k = 0; k < 3; k++) {
+    for (size_t i = 0; i < n; i++)
+      values[k][i] = dist(rng);
+    auto [a, b] = vexmaps::logger::float_bounds(values[k], n);
+    vexmaps::logger::compress_floats(values[k], quantized[k], n, a, b,
+                                     mods[k]);
+  }
+
+  LogBuffer buffer;
+  // how LogBuffer wrote varints before the bulk writers, every byte checked
+  double bytes_micros = microsPerCall(iterations, [&] {
+    buffer.clear();
+    for (size_t k = 0; k < 3; k++) {
+      for (size_t i = 0; i < n; i++) {
+        uint16_t v = LogBuffer::zigzag(quantized[k][i]);
+        while (v >= 128) {
+          buffer.writeByte(static_cast<char>(v | 128));
+          v >>= 7;
+        }
+        buffer.writeByte(static_cast<char>(v));
+      }
+    }
+  });
+  double varint_micros = microsPerCall(iterations, [&] {
+    buffer.clear();
+    for (size_t k = 0; k < 3; k++)
+      for (size_t i = 0; i < n; i++)
+        buffer.write_varint(quantized[k][i]);
+  });
+  double array_micros = microsPerCall(iterations, [&] {
+    buffer.clear();
+    for (size_t k = 0; k < 3; k++)
+      buffer.write_varint_array(quantized[k], n);
+  });
+
+  std::printf("varint writes of %zu particles (%zu bytes): byte at a time "
+              "%.2f ns/particle, varint at a time %.2f ns/particle, arrays "
+              "%.2f ns/particle\n",
+              n, buffer.size(), bytes_micros * 1000 / n,
+              varint_micros * 1000 / n, array_micros * 1000 / n);
+}
+
+// serialized bytes of the last frame in buffer, in one block
+static std::vector<char> flatten(const vexmaps::logger::LogBuffer &buffer) {
+  std::vector<char> bytes;
+  for (size_t i = 0; i < buffer.chunkCount(); i++)
+    bytes.insert(bytes.end(), buffer.chunk(i).begin(), buffer.chunk(i).end());
+  return bytes;
+}
+
+void schemaEncoding() {
+  using namespace vexmaps::logger;
+  constexpr size_t n = 3072;
+  constexpr size_t iterations = 5000;
+
+  static PFLogger<n> tree;
+  static PFMessage<n> schema;
+
+  static float x[n];
+  static float y[n];
+  static float weights[n];
+  std::ranlux24_base rng;
+  std::uniform_real_distribution<float> dist(-1.8f, 1.8f);
+  for (size_t i = 0; i < n; i++) {
+    x[i] = dist(rng);
+    y[i] = dist(rng);
+    weights[i] = std::abs(dist(rng));
+  }
+  tree.particles.addParticles(x, y, weights, n);
+  schema.particles().addParticles(x, y, weights, n);
+
+  tree.generation_info.setData(10, 500, 0.5f, 1, 2);
+  schema.generation_info().setData(10, 500, 0.5f, 1, 2);
+  tree.generation_info.distance1.setData(0, 10.5f, 10, 60, false);
+  schema.generation_info().distance1().setData(0, 10.5f, 10, 60, false);
+  tree.generation_info.distance2.setData(1, 393.33f, 10, 10, true);
+  schema.generation_info().distance2().setData(1, 393.33f, 10, 10, true);
+
+  LogBuffer buffer;
+  double tree_info = microsPerCall(iterations, [&] {
+    buffer.clear();
+    buildData(&tree.generation_info, &buffer);
+  });
+  auto tree_info_bytes = flatten(buffer);
+  double schema_info = microsPerCall(iterations, [&] {
+    buffer.clear();
+    schema.generation_info().build(&buffer);
+  });
+  bool same = flatten(buffer) == tree_info_bytes;
+
+  double tree_pf = microsPerCall(iterations / 10, [&] {
+    buffer.clear();
+    buildData(&tree, &buffer);
+  });
+  auto tree_pf_bytes = flatten(buffer);
+  double schema_pf = microsPerCall(iterations / 10, [&] {
+    buffer.clear();
+    schema.build(&buffer);
+  });
+  same &= flatten(buffer) == tree_pf_bytes;
+
+  std::printf("GenerationInfo: virtual %.0f ns, schema %.0f ns. PF frame of "
+              "%zu particles: virtual %.2f us, schema %.2f us%s\n",
+              tree_info * 1000, schema_info * 1000, n, tree_pf, schema_pf,
+              same ? "" : " DIFFERENT BYTES");
+}
+
+// how addParticles found the bounds before float_bounds, one scalar loop
+// over the three arrays
+static void scalarBounds(const float *x, const float *y, const float *weights,
+                         size_t n, std::pair<float, float> (&bounds)[3]) {
+  const float *data[3] = {x, y, weights};
+  for (size_t k = 0; k < 3; k++)
+    bounds[k] = {data[k][0], data[k][0]};
+  for (size_t i = 0; i < n; i++) {
+    for (size_t k = 0; k < 3; k++) {
+      bounds[k].first = std::min(bounds[k].first, data[k][i]);
+      bounds[k].second = std::max(bounds[k].second, data[k][i]);
+    }
+  }
+}
+
+template <size_t N> static void particleBoundsOf() {
+  using namespace vexmaps::logger;
+  const size_t iterations = 3000000 / N;
+
+  static VarintParticlesLogger<N> logger;
+  static float x[N];
+  static float y[N];
+  static float weights[N];
+  static int16_t quantized[N];
+  std::ranlux24_base rng;
+  std::uniform_real_distribution<float> dist(-1.8f, 1.8f);
+  for (size_t i = 0; i < N; i++) {
+    x[i] = dist(rng);
+    y[i] = dist(rng);
+    weights[i] = std::abs(dist(rng));
+  }
+  const float *arrays[3] = {x, y, weights};
+  const float max_error = 0.25f * 0.0254f;
+
+  std::pair<float, float> bounds[3];
+  double scalar_bounds = microsPerCall(
+      iterations, [&] { scalarBounds(x, y, weights, N, bounds); });
+  double simd_bounds =
+      microsPerCall(iterations, [&] { float_bounds(arrays, N, bounds); });
+
+  double before = microsPerCall(iterations, [&] {
+    scalarBounds(x, y, weights, N, bounds);
+    float *data[3] = {x, y, weights};
+    for (size_t k = 0; k < 3; k++) {
+      uint32_t mod =
+          error_bounded_mod(bounds[k].first, bounds[k].second, max_error);
+      compress_floats(data[k], quantized, N, bounds[k].first,
+                      bounds[k].second, mod);
+    }
+  });
+  double after =
+      microsPerCall(iterations, [&] { logger.addParticles(x, y, weights, N); });
+
+  // used, so the loops are not optimized away
+  static volatile float result;
+  result = bounds[0].first + quantized[N - 1];
+
+  std::printf("addParticles of %zu particles: scalar bounds %.2f us, "
+              "%s bounds %.2f us, generation before %.2f us, after %.2f us\n",
+              N, scalar_bounds, simd::backend_name, simd_bounds, before,
+              after);
+}
+
+void particleBounds() {
+  particleBoundsOf<1024>();
+  particleBoundsOf<3072>();
+  particleBoundsOf<8192>();
+}
+
+// varints written by LogBuffer::write_varint_array back into n int16s,
+// returns the end of them
+static const char *readVarints(const char *in, size_t n, int16_t *out) {
+  for (size_t i = 0; i < n; i++) {
+    uint32_t v = 0;
+    for (int shift = 0;; shift += 7) {
+      uint8_t byte = static_cast<uint8_t>(*in++);
+      v |= static_cast<uint32_t>(byte & 127) << shift;
+      if (!(byte & 128))
+        break;
+    }
+    out[i] = static_cast<int16_t>((v >> 1) ^ -(v & 1));
+  }
+  return in;
+}
+
+void ransDecode() {
+  using namespace vexmaps::logger;
+  constexpr size_t n = 3072;
+  constexpr size_t iterations = 5000;
+
+  // particles sorted by weight, like the host program sends
+  std::ranlux24_base rng;
+  std::uniform_real_distribution<float> x_dist(-70 * 0.0254, -40 * 0.0254);
+  std::uniform_real_distribution<float> y_dist(20 * 0.0254, 40 * 0.0254);
+  std::normal_distribution<float> weight_dist(0.2, 0.9);
+  std::vector<std::tuple<float, float, float>> particles;
+  for (size_t i = 0; i < n; i++)
+    particles.emplace_back(std::abs(weight_dist(rng)), x_dist(rng),
+                           y_dist(rng));
+  std::sort(particles.begin(), particles.end());
+
+  static float values[3][n];
+  for (size_t i = 0; i < n; i++) {
+    values[0][i] = std::get<1>(particles[i]);
+    values[1][i] = std::get<2>(particles[i]);
+    values[2][i] = std::get<0>(particles[i]);
+  }
+  static int16_t quantized[3][n];
+  for (size_t k = 0; k < 3; k++) {
+    auto [a, b] = float_bounds(values[k], n);
+    float max_error = k < 2 ? 0.25f * 0.0254f : b / (1 << 14);
+    compress_floats(values[k], quantized[k], n, a, b,
+                    error_bounded_mod(a, b, max_error));
+  }
+
+  static uint8_t encoded[3][rans::max_size(n)];
+  static uint8_t tokens[n];
+  size_t encoded_size = 0;
+  for (size_t k = 0; k < 3; k++)
+    encoded_size += rans::encode(quantized[k], n, encoded[k], tokens);
+
+  LogBuffer buffer;
+  for (size_t k = 0; k < 3; k++)
+    buffer.write_varint_array(quantized[k], n);
+  std::vector<char> varints = flatten(buffer);
+  std::vector<char> compressed(LZ4_compressBound(varints.size()));
+  int compressed_size =
+      LZ4_compress_default(varints.data(), compressed.data(), varints.size(),
+                           compressed.size());
+
+  static int16_t decoded[3][n];
+  std::vector<char> decompressed(varints.size());
+  double lz4_micros = microsPerCall(iterations, [&] {
+    LZ4_decompress_safe(compressed.data(), decompressed.data(),
+                        compressed_size, decompressed.size());
+    const char *p = decompressed.data();
+    for (size_t k = 0; k < 3; k++)
+      p = readVarints(p, n, decoded[k]);
+  });
+  bool same = std::equal(&quantized[0][0], &quantized[0][0] + 3 * n,
+                         &decoded[0][0]);
+  double rans_micros = microsPerCall(iterations, [&] {
+    for (size_t k = 0; k < 3; k++)
+      rans::decode(encoded[k], n, decoded[k]);
+  });
+  same &= std::equal(&quantized[0][0], &quantized[0][0] + 3 * n,
+                     &decoded[0][0]);
+
+  // streams shorter than a round only take the checked steps, and an empty
+  // one has no frequencies. Decoded from copies of exactly their size, so a
+  // read past the end shows up under ASan
+  for (size_t m : {0, 1, 3, 4, 5, 7}) {
+    static uint8_t short_encoded[rans::max_size(8)];
+    size_t size = rans::encode(quantized[0], m, short_encoded, tokens);
+    std::vector<uint8_t> exact(short_encoded, short_encoded + size);
+    int16_t short_decoded[8];
+    same &= rans::decode(exact.data(), m, short_decoded) == size &&
+            std::equal(quantized[0], quantized[0] + m, short_decoded);
+  }
+
+  std::printf("decode of %zu particles: varint+LZ4 %d bytes %.2f us, rANS %zu "
+              "bytes %.2f us%s\n",
+              n, compressed_size, lz4_micros, encoded_size, rans_micros,
+              same ? "" : " DIFFERENT VALUES");
+}
+
+void runAll() {
+  sinkThroughput();
+  varintWrites();
+  schemaEncoding();
+  particleBounds();
+  ransDecode();
+}
+
+} // namespace benchmarks
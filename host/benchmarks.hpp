@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Benchmarks of the host build, run with `bin/host/vexlog --bench`
+ */
+
+#pragma once
+
+#include "vexlog/platform.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace benchmarks {
+
+/**
+ * @brief Average microseconds per call of f, after one call to warm up
+ */
+template <typename F> double microsPerCall(size_t iterations, F &&f) {
+  f();
+  auto start = vexmaps::logger::platform::micros();
+  for (size_t i = 0; i < iterations; i++)
+    f();
+  auto end = vexmaps::logger::platform::micros();
+  return static_cast<double>(end - start) / iterations;
+}
+
+// iostream vs FdSink for 10KB frames
+void sinkThroughput();
+
+// byte at a time, varint at a time and whole array varint writes of the
+// particle arrays of VarintParticlesLogger
+void varintWrites();
+
+// virtual BaseMessageLogger trees vs the schema::Message versions, also
+// checks that both write the same bytes
+void schemaEncoding();
+
+// VarintParticlesLogger::addParticles vs separate scalar bounds loops plus
+// quantization, at N = 1024, 3072 and 8192
+void particleBounds();
+
+// rANS decoding of the particle arrays of RansParticlesLogger vs LZ4 and
+// varint decoding of the same arrays, also checks both give them back
+void ransDecode();
+
+void runAll();
+
+} // namespace benchmarks
@@ -0,0 +1,372 @@
+/**
+ * @file
+ * @brief Workstation counterpart of src/main.cpp, built with `make host`
+ *
+ * Sends the same simulated particle filter generation as the robot program to
+ * stdout. If a path is given as the first argument the uncompressed message is
+ * also dumped there, which makes it easy to compare SIMD backends with cmp.
+ * The error of the particle quantization is checked against its bound, every
+ * particle format is decoded again (see roundtrip.cpp), LogSession and FanOut
+ * are checked not to allocate once warmed up, and the
+ * rate controller is run against a simulated serial link. `--bench` runs the
+ * benchmarks in benchmarks.cpp instead.
+ */
+
+#include "benchmarks.hpp"
+#include "roundtrip.hpp"
+#include "vexlog/fanout.hpp"
+#include "vexlog/float_compression.hpp"
+#include "vexlog/logger.hpp"
+#include "vexlog/pf_logger.hpp"
+#include "vexlog/rate_control.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <span>
+#include <fstream>
+#include <new>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// every heap allocation of the program, to check the steady state of
+// LogSession
+std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  size_t align = static_cast<size_t>(alignment);
+  // aligned_alloc wants a multiple of the alignment
+  if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+const size_t N = 3072;
+
+vexmaps::logger::PFLogger<N> logger;
+
+// max and RMS error of compress_floats with the smallest mod for max_error,
+// false if the bound was missed
+bool checkQuantization(const char *name, const float *data, float max_error) {
+  static int16_t compressed[N];
+  auto [a, b] = vexmaps::logger::float_bounds(data, N);
+  uint32_t mod = vexmaps::logger::error_bounded_mod(a, b, max_error);
+  vexmaps::logger::compress_floats(const_cast<float *>(data), compressed, N, a,
+                                   b, mod);
+  auto error =
+      vexmaps::logger::quantization_error(data, compressed, N, a, b, mod);
+  bool ok = error.max <= max_error;
+  std::printf("%s: mod %u, max error %g (bound %g), rms %g%s\n", name, mod,
+              error.max, max_error, error.rms, ok ? "" : " OVER BOUND");
+  return ok;
+}
+
+// heap allocations of LogSession::send once a few frames went out, false if
+// there were any
+bool checkSteadyState(const char *name, vexmaps::logger::LogSession &session,
+                      const float *x, const float *y, const float *weights) {
+  int fd = ::open("/dev/null", O_WRONLY);
+  vexmaps::logger::FdSink sink(fd);
+  session.setSink(sink);
+
+  static vexmaps::logger::PFLogger<N> pf;
+  static float moved_x[N];
+  size_t counted = 0;
+  for (int frame = 0; frame < 100; frame++) {
+    // the frame size changes a little every generation
+    for (size_t i = 0; i < N; i++)
+      moved_x[i] = x[i] + (frame % 7) * 0.001f * (i % 5);
+    pf.particles.addParticles(moved_x, const_cast<float *>(y),
+                              const_cast<float *>(weights), N);
+    size_t before = allocations.load();
+    session.send(pf);
+    // the first frames size the buffers
+    if (frame >= 10)
+      counted += allocations.load() - before;
+  }
+  session.flush();
+  ::close(fd);
+
+  std::printf("%s: %zu allocations in 90 steady state sends%s\n", name,
+              counted, counted == 0 ? "" : " NOT ZERO");
+  return counted == 0;
+}
+
+// same for a FanOut feeding a ring of frames, a frame transmitter and a plain
+// sink, which all hold on to frames differently. Also false if a decimated
+// ring has gaps in its sequence numbers
+bool checkFanOutSteadyState(const float *x, const float *y,
+                            const float *weights) {
+  int fd = ::open("/dev/null", O_WRONLY);
+  vexmaps::logger::FdSink sink(fd);
+  vexmaps::logger::SinkAdapter adapter(sink, true);
+  vexmaps::logger::FrameRing ring(16);
+  vexmaps::logger::FrameRing decimated_ring(8);
+  vexmaps::logger::FrameTransmitter transmitter(fd, 4);
+
+  vexmaps::logger::FanOut fanout;
+  fanout.addSink(adapter);
+  fanout.addSink(ring);
+  fanout.addSink(decimated_ring, {.decimation = 3});
+  fanout.addSink(transmitter, {.decimation = 2});
+
+  static vexmaps::logger::PFLogger<N> pf;
+  static float moved_x[N];
+  size_t counted = 0;
+  for (int frame = 0; frame < 200; frame++) {
+    for (size_t i = 0; i < N; i++)
+      moved_x[i] = x[i] + (frame % 7) * 0.001f * (i % 5);
+    pf.particles.addParticles(moved_x, const_cast<float *>(y),
+                              const_cast<float *>(weights), N);
+    size_t before = allocations.load();
+    fanout.publish(pf);
+    // every other frame, so frames wait in the transmitter
+    if (frame % 2 == 1)
+      transmitter.pump(SIZE_MAX);
+    // until every pooled buffer was sized
+    if (frame >= 50)
+      counted += allocations.load() - before;
+  }
+  ::close(fd);
+
+  vexmaps::logger::PacketDecoder decoder;
+  vexmaps::logger::PacketDecoder::Packet packet;
+  for (size_t i = 0; i < decimated_ring.size(); i++) {
+    decoder.push(decimated_ring.get(i)->bytes());
+    while (decoder.next(packet))
+      ;
+  }
+  bool ok = counted == 0 && decoder.receivedPackets() == decimated_ring.size() &&
+            decoder.lostPackets() == 0;
+
+  std::printf("FanOut: %zu allocations in 150 steady state publishes, %u "
+              "packets lost by a decimated sink%s\n",
+              counted, decoder.lostPackets(), ok ? "" : " FAILED");
+  return ok;
+}
+
+// clock of the throttled link simulation, micros() returns it while it runs
+uint64_t simulated_now = 0;
+
+uint64_t simulatedNow() { return simulated_now; }
+
+// serial link draining link_rate bytes per second out of a transmit buffer,
+// writes block (move the simulated clock forward) while it is full
+class ThrottledSink : public vexmaps::logger::Sink {
+private:
+  uint32_t link_rate;
+  size_t tx_buffer;
+  double queued = 0;
+  uint64_t drained_at = 0;
+
+  void drain() {
+    queued = std::max(0.0, queued - (simulated_now - drained_at) * 1e-6 *
+                                        link_rate);
+    drained_at = simulated_now;
+  }
+
+public:
+  // (time, bytes) of every write
+  std::vector<std::pair<uint64_t, size_t>> writes;
+  uint64_t blocked = 0;
+
+  ThrottledSink(uint32_t link_rate, size_t tx_buffer)
+      : link_rate(link_rate), tx_buffer(tx_buffer) {}
+
+  bool write(std::span<const char> data) override {
+    drain();
+    uint64_t start = simulated_now;
+    queued += data.size();
+    if (queued > tx_buffer) {
+      simulated_now += static_cast<uint64_t>(
+          std::ceil((queued - tx_buffer) * 1e6 / link_rate));
+      drain();
+    }
+    blocked += simulated_now - start;
+    writes.emplace_back(start, data.size());
+    return true;
+  }
+
+  bool flush() override { return true; }
+};
+
+// sends 60s of 50Hz generations through a RateLimitedPFLogger and a link
+// with a 1KB transmit buffer, false if any 1s window carried more than the
+// token bucket allows or if no full frame went out although the rate has room
+// for one every second
+bool simulateThrottledLink(const float *x, const float *y,
+                           const float *weights, uint32_t link_rate,
+                           uint32_t budget) {
+  constexpr uint64_t period = 20000;
+  constexpr uint64_t duration = 60000000;
+  const uint32_t burst = 12 * 1024;
+
+  static vexmaps::logger::RateLimitedPFLogger<N, N / 8> pf;
+  pf.generation_info.setData(10, 500, 0, 10, 20);
+
+  ThrottledSink link(link_rate, 1024);
+  vexmaps::logger::LogSession session;
+  session.setSink(link);
+  vexmaps::logger::RateController controller(budget, burst, link_rate);
+
+  // particles move a little every generation, so frame sizes vary
+  static float moved_x[N];
+  static float moved_y[N];
+  std::ranlux24_base rng;
+  std::normal_distribution<float> noise(0, 0.5f * 0.0254f);
+
+  simulated_now = 0;
+  vexmaps::logger::platform::setClock(simulatedNow);
+  int counts[4] = {};
+  int lost = 0;
+  for (uint64_t tick = 0; tick < duration; tick += period) {
+    // generations that came while a write was blocking are never logged
+    if (tick < simulated_now) {
+      lost++;
+      continue;
+    }
+    simulated_now = tick;
+    for (size_t i = 0; i < N; i++) {
+      moved_x[i] = x[i] + noise(rng);
+      moved_y[i] = y[i] + noise(rng);
+    }
+    pf.addParticles(moved_x, moved_y, const_cast<float *>(weights), N);
+    counts[static_cast<int>(pf.send(session, controller))]++;
+  }
+  vexmaps::logger::platform::setClock(nullptr);
+
+  size_t sent = 0;
+  size_t window_bytes = 0;
+  size_t worst_window = 0;
+  size_t first = 0;
+  for (auto [time, bytes] : link.writes) {
+    sent += bytes;
+    window_bytes += bytes;
+    while (link.writes[first].first + 1000000 <= time)
+      window_bytes -= link.writes[first++].second;
+    worst_window = std::max(worst_window, window_bytes);
+  }
+
+  // 1 byte of slack for float rounding in the bucket
+  uint32_t rate = std::min(link_rate, budget);
+  float bound = burst + rate + controller.largestUnderestimate() + 1;
+  bool ok = worst_window <= bound;
+
+  // raw size, an upper bound of what a full frame takes on the link
+  static vexmaps::logger::PFLogger<N> full;
+  full.generation_info.setData(10, 500, 0, 10, 20);
+  full.particles.addParticles(moved_x, moved_y, const_cast<float *>(weights),
+                              N);
+  bool full_ok = rate < full.encodedSize() || counts[0] > 0;
+  std::printf("link %u B/s, budget %u B/s: full %d, decimated %d, info %d, "
+              "skipped %d, lost %d, blocked %.1fs, average %.0f B/s, worst 1s "
+              "window %zu B (bound %.0f B)%s%s\n",
+              link_rate, budget, counts[0], counts[1], counts[2], counts[3],
+              lost, link.blocked * 1e-6, sent * 1e6 / duration, worst_window,
+              bound, ok ? "" : " OVER BUDGET",
+              full_ok ? "" : " NO FULL FRAMES");
+  return ok && full_ok;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+    benchmarks::runAll();
+    return 0;
+  }
+
+  static float x[N];
+  static float y[N];
+  static float weights[N];
+
+  std::ranlux24_base rng;
+
+  std::uniform_real_distribution<float> x_dist(-70 * 0.0254, -40 * 0.0254);
+  std::uniform_real_distribution<float> y_dist(20 * 0.0254, 40 * 0.0254);
+  std::normal_distribution<float> weight_dist(0.2, 0.9);
+
+  std::vector<std::tuple<float, float, float>> particles;
+
+  for (int i = 0; i < N; i++) {
+    particles.emplace_back(std::abs(weight_dist(rng)), x_dist(rng),
+                           y_dist(rng));
+  }
+
+  sort(particles.begin(), particles.end());
+
+  for (int i = 0; i < N; i++) {
+    weights[i] = std::get<0>(particles[i]);
+    x[i] = std::get<1>(particles[i]);
+    y[i] = std::get<2>(particles[i]);
+  }
+
+  auto start_time = vexmaps::logger::platform::micros();
+
+  logger.particles.addParticles(x, y, weights, N);
+
+  logger.generation_info.distance1.setData(0, 10.5, 10, 60, false);
+  logger.generation_info.distance2.setData(1, 393.33, 10, 10, true);
+  logger.generation_info.distance3.setData(2, 20.0, 33, 60, false);
+  logger.generation_info.distance4.setData(3, 50.1, 58, 60, false);
+  logger.generation_info.setData(10, 500, 0, 10, 20);
+
+  auto end_time = vexmaps::logger::platform::micros();
+
+  if (argc > 1) {
+    vexmaps::logger::LogBuffer buf;
+    vexmaps::logger::buildData(&logger, &buf);
+    std::ofstream out(argv[1], std::ios::binary);
+    for (size_t i = 0; i < buf.chunkCount(); i++)
+      out.write(buf.chunk(i).data(), buf.chunk(i).size());
+  }
+
+  vexmaps::logger::sendData(&logger);
+  std::cout << "input data time: " << end_time - start_time
+            << ", simd backend: " << vexmaps::logger::simd::backend_name
+            << std::endl;
+
+  // same bounds as the defaults of VarintParticlesLogger
+  auto [low, high] = vexmaps::logger::float_bounds(weights, N);
+  float largest_weight = std::max(std::abs(low), std::abs(high));
+  bool ok = checkQuantization("x", x, 0.25f * 0.0254f);
+  ok &= checkQuantization("y", y, 0.25f * 0.0254f);
+  ok &= checkQuantization("weights", weights, largest_weight / (1 << 14));
+  ok &= roundtrip::checkParticleFormats();
+  ok &= roundtrip::checkTemporal();
+
+  {
+    vexmaps::logger::LogSession session;
+    ok &= checkSteadyState("LogSession", session, x, y, weights);
+  }
+  {
+    vexmaps::logger::LogSession session;
+    session.setStreaming(16);
+    ok &= checkSteadyState("streaming LogSession", session, x, y, weights);
+  }
+  ok &= checkFanOutSteadyState(x, y, weights);
+
+  ok &= simulateThrottledLink(x, y, weights, 11520, 8000);
+  ok &= simulateThrottledLink(x, y, weights, 4000, 8000);
+  ok &= simulateThrottledLink(x, y, weights, 11520, 11520);
+  ok &= simulateThrottledLink(x, y, weights, 100000, 30000);
+
+  return ok ? 0 : 1;
+}
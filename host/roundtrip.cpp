@@ -0,0 +1,440 @@
+#include "roundtrip.hpp"
+#include "vexlog/bitpack.hpp"
+#include "vexlog/float_compression.hpp"
+#include "vexlog/logger.hpp"
+#include "vexlog/pf_logger.hpp"
+#include "vexlog/rans.hpp"
+#include "vexlog/stream_vbyte.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace roundtrip {
+
+using namespace vexmaps::logger;
+
+// same defaults as VarintParticlesLogger
+constexpr float position_error = 0.25f * 0.0254f;
+constexpr float weight_error = 1.0f / (1 << 14);
+
+// the block decoders may read a little past their values
+constexpr size_t padding = 64;
+
+// reads a particle message the way a receiver does, reads past the end give
+// zeros and clear ok
+class Reader {
+private:
+  std::vector<uint8_t> bytes;
+  size_t pos = 0;
+  size_t size;
+
+public:
+  bool ok = true;
+
+  // the payload of message, which has to be alone in the frame
+  Reader(BaseMessageLogger &message) {
+    LogBuffer buffer;
+    buildData(&message, &buffer);
+    for (size_t i = 0; i < buffer.chunkCount(); i++)
+      bytes.insert(bytes.end(), buffer.chunk(i).begin(), buffer.chunk(i).end());
+    size = bytes.size();
+    bytes.resize(size + padding);
+
+    ok = byte() == static_cast<uint8_t>(message.getMagic1()) &&
+         byte() == static_cast<uint8_t>(message.getMagic2()) &&
+         varint() == size - pos;
+  }
+
+  uint8_t byte() {
+    if (pos >= size) {
+      ok = false;
+      return 0;
+    }
+    return bytes[pos++];
+  }
+
+  // little endian, like the robot writes them
+  float f32() {
+    uint32_t bits = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+      bits |= static_cast<uint32_t>(byte()) << shift;
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+
+  uint32_t varint() {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      uint8_t b = byte();
+      v |= static_cast<uint32_t>(b & 127) << shift;
+      if (!(b & 128))
+        break;
+    }
+    return v;
+  }
+
+  int32_t svarint() {
+    uint32_t v = varint();
+    return static_cast<int32_t>((v >> 1) ^ -(v & 1));
+  }
+
+  void int16Varints(size_t n, int16_t *out) {
+    for (size_t i = 0; i < n; i++)
+      out[i] = static_cast<int16_t>(svarint());
+  }
+
+  // n values of a block format, decode returns the bytes it used
+  template <typename Decode> void blocks(size_t n, int16_t *out, Decode decode) {
+    pos += decode(bytes.data() + pos, n, out);
+    ok &= pos <= size;
+  }
+
+  bool atEnd() const { return pos == size; }
+};
+
+struct Bounds {
+  float min;
+  float max;
+  uint32_t mod;
+};
+
+static Bounds readBounds(Reader &in) {
+  Bounds b;
+  b.min = in.f32();
+  b.max = in.f32();
+  b.mod = in.varint();
+  return b;
+}
+
+// largest difference between decoded and data, relative to scale
+static float maxError(const float *decoded, const float *data, size_t n,
+                      float scale = 1) {
+  float max = 0;
+  for (size_t i = 0; i < n; i++)
+    max = std::max(max, std::abs(decoded[i] - data[i]) / scale);
+  return max;
+}
+
+static float largestMagnitude(const float *data, size_t n) {
+  auto [low, high] = float_bounds(data, n);
+  return std::max(std::abs(low), std::abs(high));
+}
+
+// particles spread like the host program sends them, resampled so every
+// particle has copies copies right after it
+template <size_t N>
+static void makeParticles(float *x, float *y, float *weights, size_t copies) {
+  std::ranlux24_base rng;
+  std::uniform_real_distribution<float> x_dist(-70 * 0.0254, -40 * 0.0254);
+  std::uniform_real_distribution<float> y_dist(20 * 0.0254, 40 * 0.0254);
+  std::normal_distribution<float> weight_dist(0.2, 0.9);
+  for (size_t i = 0; i < N; i += copies) {
+    float px = x_dist(rng);
+    float py = y_dist(rng);
+    float pw = std::abs(weight_dist(rng));
+    for (size_t k = i; k < std::min(i + copies, N); k++) {
+      x[k] = px;
+      y[k] = py;
+      weights[k] = pw;
+    }
+  }
+}
+
+// decodes one format of N particles and compares it with what was logged.
+// decodeArrays reads the particle arrays after the bounds
+template <size_t N, template <size_t> class Logger, typename DecodeArrays>
+static bool checkFormat(const char *name, DecodeArrays decodeArrays) {
+  static float x[N];
+  static float y[N];
+  static float weights[N];
+  makeParticles<N>(x, y, weights, 1);
+
+  static Logger<N> logger;
+  logger.addParticles(x, y, weights, N);
+
+  Reader in(logger);
+  Bounds bounds[3];
+  for (auto &b : bounds)
+    b = readBounds(in);
+  static int16_t deltas[3][N];
+  decodeArrays(in, deltas);
+
+  static float decoded[3][N];
+  for (int k = 0; k < 3; k++)
+    decompress_floats(deltas[k], decoded[k], N, bounds[k].min, bounds[k].max,
+                      bounds[k].mod);
+
+  float x_error = maxError(decoded[0], x, N);
+  float y_error = maxError(decoded[1], y, N);
+  float weight_error_seen =
+      maxError(decoded[2], weights, N, largestMagnitude(weights, N));
+  bool ok = in.ok && in.atEnd() && x_error <= position_error &&
+            y_error <= position_error && weight_error_seen <= weight_error;
+  std::printf("%s<%zu>: max error x %g, y %g (bound %g), weights %g of the "
+              "largest (bound %g)%s\n",
+              name, N, x_error, y_error, position_error, weight_error_seen,
+              weight_error, ok ? "" : " FAILED");
+  return ok;
+}
+
+// repeats every unique particle count times, which gives back the order of
+// makeParticles
+template <size_t N> static bool checkDedup() {
+  constexpr size_t copies = 4;
+  static float x[N];
+  static float y[N];
+  static float weights[N];
+  makeParticles<N>(x, y, weights, copies);
+
+  static DedupParticlesLogger<N> logger;
+  logger.addParticles(x, y, weights, N);
+
+  Reader in(logger);
+  Bounds bounds[3];
+  for (auto &b : bounds)
+    b = readBounds(in);
+  bool ok = in.varint() == N;
+  size_t unique = in.varint();
+  ok &= unique == (N + copies - 1) / copies;
+  unique = std::min(unique, N);
+
+  static int16_t deltas[3][N];
+  static float decoded[3][N];
+  static float expanded[3][N];
+  for (int k = 0; k < 3; k++) {
+    in.int16Varints(unique, deltas[k]);
+    decompress_floats(deltas[k], decoded[k], unique, bounds[k].min,
+                      bounds[k].max, bounds[k].mod);
+  }
+  size_t i = 0;
+  for (size_t u = 0; u < unique; u++) {
+    uint32_t count = in.varint();
+    for (uint32_t c = 0; c < count && i < N; c++, i++)
+      for (int k = 0; k < 3; k++)
+        expanded[k][i] = decoded[k][u];
+  }
+  ok &= i == N;
+
+  float x_error = maxError(expanded[0], x, i);
+  float y_error = maxError(expanded[1], y, i);
+  float weight_error_seen =
+      maxError(expanded[2], weights, i, largestMagnitude(weights, N));
+  ok &= in.ok && in.atEnd() && x_error <= position_error &&
+        y_error <= position_error && weight_error_seen <= weight_error;
+  std::printf("DedupParticlesLogger<%zu>: %zu unique, max error x %g, y %g "
+              "(bound %g), weights %g of the largest (bound %g)%s\n",
+              N, unique, x_error, y_error, position_error, weight_error_seen,
+              weight_error, ok ? "" : " FAILED");
+  return ok;
+}
+
+template <size_t N> static bool checkFormats() {
+  auto varints = [](Reader &in, int16_t (&deltas)[3][N]) {
+    for (auto &d : deltas)
+      in.int16Varints(N, d);
+  };
+  // the rest write N before their arrays
+  auto blocks = [](auto decode) {
+    return [decode](Reader &in, int16_t (&deltas)[3][N]) {
+      in.ok &= in.varint() == N;
+      for (auto &d : deltas)
+        in.blocks(N, d, decode);
+    };
+  };
+
+  bool ok = checkFormat<N, VarintParticlesLogger>("VarintParticlesLogger",
+                                                  varints);
+  ok &= checkFormat<N, StreamVByteParticlesLogger>(
+      "StreamVByteParticlesLogger", blocks(stream_vbyte::decode));
+  ok &= checkFormat<N, BitPackedParticlesLogger>("BitPackedParticlesLogger",
+                                                 blocks(bitpack::decode));
+  ok &= checkFormat<N, RansParticlesLogger>("RansParticlesLogger",
+                                            blocks(rans::decode));
+  ok &= checkDedup<N>();
+  return ok;
+}
+
+bool checkParticleFormats() {
+  // 1000 leaves partial vectors and blocks in every format
+  bool ok = checkFormats<3072>();
+  ok &= checkFormats<1000>();
+  return ok;
+}
+
+// receiver side of TemporalParticlesLogger, keeps the positions of the last
+// generation in subdivisions
+template <size_t N> class TemporalDecoder {
+private:
+  static constexpr int subdivisions = TemporalParticlesLogger<N>::subdivisions;
+
+  int16_t x[N];
+  int16_t y[N];
+  float x_origin = 0;
+  float y_origin = 0;
+  float step = 0;
+  uint32_t frames_since_keyframe = 0;
+  bool synced = false;
+
+public:
+  int keyframes = 0;
+  int parent_frames = 0;
+
+  // false if the generation could not be decoded
+  bool decode(Reader &in, float *out_x, float *out_y, float *out_weights) {
+    uint8_t flags = in.byte();
+    if (in.varint() != N)
+      return false;
+    uint32_t frames = in.varint();
+    Bounds weight_bounds = readBounds(in);
+
+    bool keyframe = flags & TemporalParticlesLogger<N>::flag_keyframe;
+    int16_t x_shift = 0;
+    int16_t y_shift = 0;
+    if (keyframe) {
+      x_origin = in.f32();
+      y_origin = in.f32();
+      step = in.f32();
+      synced = true;
+      keyframes++;
+    } else {
+      if (!synced || frames != frames_since_keyframe + 1)
+        return false;
+      x_shift = static_cast<int16_t>(in.svarint());
+      y_shift = static_cast<int16_t>(in.svarint());
+    }
+    frames_since_keyframe = frames;
+
+    static uint16_t parents[N];
+    bool has_parents = flags & TemporalParticlesLogger<N>::flag_parents;
+    if (has_parents) {
+      static int16_t parent_deltas[N];
+      in.int16Varints(N, parent_deltas);
+      uint16_t last = 0;
+      for (size_t i = 0; i < N; i++) {
+        last += parent_deltas[i];
+        if (last >= N)
+          return false;
+        parents[i] = last;
+      }
+      parent_frames++;
+    }
+
+    static int16_t rx[N];
+    static int16_t ry[N];
+    static int16_t rw[N];
+    in.int16Varints(N, rx);
+    in.int16Varints(N, ry);
+    in.int16Varints(N, rw);
+
+    // int16 so positions wrap the same way as on the robot
+    static int16_t px[N];
+    static int16_t py[N];
+    int16_t last_x = 0;
+    int16_t last_y = 0;
+    for (size_t i = 0; i < N; i++) {
+      if (keyframe) {
+        last_x += rx[i];
+        last_y += ry[i];
+        px[i] = static_cast<int16_t>(subdivisions * last_x);
+        py[i] = static_cast<int16_t>(subdivisions * last_y);
+      } else {
+        size_t p = has_parents ? parents[i] : i;
+        px[i] = static_cast<int16_t>(x[p] + x_shift + subdivisions * rx[i]);
+        py[i] = static_cast<int16_t>(y[p] + y_shift + subdivisions * ry[i]);
+      }
+    }
+    std::copy(px, px + N, x);
+    std::copy(py, py + N, y);
+
+    const float fine = step / subdivisions;
+    for (size_t i = 0; i < N; i++) {
+      out_x[i] = x_origin + x[i] * fine;
+      out_y[i] = y_origin + y[i] * fine;
+    }
+    decompress_floats(rw, out_weights, N, weight_bounds.min,
+                      weight_bounds.max, weight_bounds.mod);
+    return in.ok && in.atEnd();
+  }
+};
+
+template <size_t N> static bool checkTemporalOf() {
+  using Logger = TemporalParticlesLogger<N>;
+  constexpr int generations = 10;
+  constexpr uint32_t keyframe_interval = 4;
+
+  static float x[N];
+  static float y[N];
+  static float weights[N];
+  makeParticles<N>(x, y, weights, 1);
+
+  static Logger logger(keyframe_interval);
+  TemporalDecoder<N> decoder;
+
+  std::ranlux24_base rng;
+  std::uniform_int_distribution<uint16_t> parent_dist(0, N - 1);
+  std::normal_distribution<float> noise(0, 0.3f * 0.0254f);
+  std::normal_distribution<float> weight_dist(0.2, 0.9);
+
+  static float prev_x[N];
+  static float prev_y[N];
+  static uint16_t parents[N];
+  static float decoded[3][N];
+  bool ok = true;
+  float x_error = 0;
+  float y_error = 0;
+  float weight_error_seen = 0;
+  for (int generation = 0; generation < generations; generation++) {
+    // odd generations are resampled, the rest only move
+    bool resampled = generation % 2 == 1;
+    if (generation > 0) {
+      std::copy(x, x + N, prev_x);
+      std::copy(y, y + N, prev_y);
+      for (auto &p : parents)
+        p = parent_dist(rng);
+      std::sort(parents, parents + N);
+      for (size_t i = 0; i < N; i++) {
+        size_t p = resampled ? parents[i] : i;
+        x[i] = prev_x[p] + 0.02f + noise(rng);
+        y[i] = prev_y[p] - 0.01f + noise(rng);
+        weights[i] = std::abs(weight_dist(rng));
+      }
+    }
+    logger.addParticles(x, y, weights, N, resampled ? parents : nullptr);
+
+    Reader in(logger);
+    ok &= in.ok && decoder.decode(in, decoded[0], decoded[1], decoded[2]);
+    x_error = std::max(x_error, maxError(decoded[0], x, N));
+    y_error = std::max(y_error, maxError(decoded[1], y, N));
+    weight_error_seen =
+        std::max(weight_error_seen, maxError(decoded[2], weights, N,
+                                             largestMagnitude(weights, N)));
+  }
+
+  // the grid bound plus a few ulps of float error in decoding
+  float bound = Logger::max_position_error + 4 * 2.0f * FLT_EPSILON;
+  ok &= x_error <= bound && y_error <= bound &&
+        weight_error_seen <= weight_error;
+  ok &= decoder.keyframes == (generations + keyframe_interval - 1) /
+                                 keyframe_interval &&
+        decoder.parent_frames > 0;
+  std::printf("TemporalParticlesLogger<%zu>: %d generations, %d keyframes, "
+              "%d with parents, max error x %g, y %g (bound %g), weights %g "
+              "of the largest (bound %g)%s\n",
+              N, generations, decoder.keyframes, decoder.parent_frames,
+              x_error, y_error, bound, weight_error_seen, weight_error,
+              ok ? "" : " FAILED");
+  return ok;
+}
+
+bool checkTemporal() {
+  bool ok = checkTemporalOf<3072>();
+  ok &= checkTemporalOf<1000>();
+  return ok;
+}
+
+} // namespace roundtrip
@@ -0,0 +1,22 @@
+/**
+ * @file
+ * @brief Checks that what the particle loggers write decodes back within
+ * their error bounds. The decoders are written from the format comments in
+ * pf_logger.hpp, like the ones of the JS parser
+ */
+
+#pragma once
+
+namespace roundtrip {
+
+// VarintParticlesLogger and the formats that share its quantization (0x49,
+// 0x4a, 0x4c, 0x4d and 0x4e), also with N not a multiple of the vector
+// widths. Prints a line per format, false if a value missed its bound
+bool checkParticleFormats();
+
+// generations of TemporalParticlesLogger with and without parents and across
+// keyframes, decoded with the state of the previous generation like a
+// receiver does. False if a value missed its bound
+bool checkTemporal();
+
+} // namespace roundtrip
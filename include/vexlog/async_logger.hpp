@@ -0,0 +1,254 @@
+/**
+ * @file
+ * @brief Asynchronous logging, frames are serialized on the caller's task and
+ * compressed and sent from a dedicated logging task
+ */
+
+#pragma once
+
+#include "logger.hpp"
+#include "platform.hpp"
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace vexmaps {
+namespace logger {
+
+/**
+ * @brief Lock free queue of slot indices.
+ *
+ * Only one task may push, but both tasks may pop (the producer pops the
+ * oldest frame when dropping it). The queue can never hold more indices than
+ * the number of slots it was made for, so pushes never fail.
+ */
+class SlotQueue {
+private:
+  std::unique_ptr<uint32_t[]> indices;
+  // capacity - 1, the capacity is rounded up to a power of two
+  uint32_t mask;
+  // monotonic counters, wrapping is fine since only the difference matters and
+  // the capacity divides 2^32
+  std::atomic<uint32_t> head{0};
+  std::atomic<uint32_t> tail{0};
+
+public:
+  SlotQueue(uint32_t capacity)
+      : indices(std::make_unique<uint32_t[]>(std::bit_ceil(capacity))),
+        mask(std::bit_ceil(capacity) - 1) {}
+
+  void push(uint32_t index) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    indices[t & mask] = index;
+    tail.store(t + 1, std::memory_order_release);
+  }
+
+  bool pop(uint32_t &index) {
+    uint32_t h = head.load(std::memory_order_acquire);
+    while (h != tail.load(std::memory_order_acquire)) {
+      index = indices[h & mask];
+      if (head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel))
+        return true;
+    }
+    return false;
+  }
+
+  uint32_t size() const {
+    return tail.load(std::memory_order_acquire) -
+           head.load(std::memory_order_acquire);
+  }
+};
+
+/**
+ * @brief Double buffered logger that never blocks the caller on compression
+ * or on the serial port.
+ *
+ * publish() serializes the message into a preallocated slot and hands it to
+ * the logging task, which compresses and sends it with its own LogSession
+ * (set it up with getSession() before start()). When every slot is still
+ * waiting to be sent the overrun policy decides what gets dropped.
+ */
+class AsyncLogger {
+public:
+  enum class OverrunPolicy {
+    // replace the oldest frame that was not sent yet
+    DropOldest,
+    // discard the frame being published
+    DropNewest,
+    // wait until the logging task frees a slot
+    Block
+  };
+
+private:
+  // one slot more than the queue depth, the logging task holds one slot while
+  // sending it
+  std::vector<LogBuffer> slots;
+  std::vector<size_t> slot_sizes;
+  SlotQueue free_slots;
+  SlotQueue ready_slots;
+
+  OverrunPolicy policy;
+
+  LogSession session;
+  std::unique_ptr<platform::Task> task;
+  std::atomic<bool> running{false};
+  // posted when a frame is queued or on stop(), wakes the logging task
+  platform::BinarySemaphore frame_ready;
+  // posted when the logging task frees a slot, wakes a waiting publish()
+  platform::BinarySemaphore slot_freed;
+
+  std::atomic<uint32_t> published_frames{0};
+  std::atomic<uint32_t> sent_frames{0};
+  std::atomic<uint32_t> dropped_frames{0};
+
+  static void taskFunction(void *arg) {
+    static_cast<AsyncLogger *>(arg)->loop();
+  }
+
+  void loop() {
+    while (true) {
+      uint32_t slot;
+      if (ready_slots.pop(slot)) {
+        session.transmit(slots[slot], slot_sizes[slot]);
+        free_slots.push(slot);
+        slot_freed.post();
+        sent_frames.fetch_add(1, std::memory_order_relaxed);
+      } else if (!running.load(std::memory_order_acquire)) {
+        // everything published before stop() has been sent
+        return;
+      } else {
+        // a post between the pop and here is kept, so no frame is missed
+        frame_ready.wait(platform::wait_forever);
+      }
+    }
+  }
+
+  // returns false if the frame should be dropped
+  bool acquireSlot(uint32_t &slot) {
+    while (!free_slots.pop(slot)) {
+      switch (policy) {
+      case OverrunPolicy::DropNewest:
+        dropped_frames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      case OverrunPolicy::DropOldest:
+        // can only fail if the logging task just took it, then a slot is
+        // about to be freed. The logging task has a lower priority, so
+        // spinning would keep it from ever freeing it
+        if (ready_slots.pop(slot)) {
+          dropped_frames.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+        slot_freed.wait(platform::wait_forever);
+        break;
+      case OverrunPolicy::Block:
+        slot_freed.wait(platform::wait_forever);
+        break;
+      }
+    }
+    return true;
+  }
+
+  void publishSlot(uint32_t slot, size_t size) {
+    slot_sizes[slot] = size;
+    ready_slots.push(slot);
+    published_frames.fetch_add(1, std::memory_order_relaxed);
+    frame_ready.post();
+  }
+
+public:
+  /**
+   * @param depth how many frames can wait to be sent, at least 1
+   * @param frame_size bytes allocated in every slot up front. A slot only
+   * grows for a frame that needs more, so a little more than the maxSize() of
+   * the largest message (it leaves out the category headers) keeps publish()
+   * from allocating
+   */
+  AsyncLogger(uint32_t depth = 2,
+              OverrunPolicy policy = OverrunPolicy::DropOldest,
+              size_t frame_size = LogBuffer::default_chunk_size)
+      : slots(depth + 1), slot_sizes(depth + 1), free_slots(depth + 1),
+        ready_slots(depth + 1), policy(policy) {
+    // with no slot to wait in, publish() would wait for the one being sent
+    assert((depth >= 1) && "depth must be at least 1");
+    for (uint32_t i = 0; i < depth + 1; i++) {
+      slots[i].reserve(frame_size);
+      free_slots.push(i);
+    }
+  }
+
+  AsyncLogger(const AsyncLogger &) = delete;
+  AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+  ~AsyncLogger() { stop(); }
+
+  /**
+   * @brief Session the logging task sends with, to set its sink, codec,
+   * streaming or dictionary. Only use it while the logging task is not
+   * running, before start() or after stop()
+   */
+  LogSession &getSession() {
+    assert(!running.load() && "the logging task is using the session");
+    return session;
+  }
+
+  /**
+   * @brief Starts the logging task
+   */
+  void start() {
+    if (running.exchange(true))
+      return;
+    task = std::make_unique<platform::Task>(taskFunction, this, "vexlog");
+  }
+
+  /**
+   * @brief Sends whatever is still queued and stops the logging task
+   */
+  void stop() {
+    if (!running.exchange(false))
+      return;
+    frame_ready.post();
+    task->join();
+    task.reset();
+  }
+
+  /**
+   * @brief Serializes message and queues it for sending. Only call from one
+   * task at a time
+   *
+   * @return false if the frame was dropped
+   */
+  bool publish(BaseMessageLogger &message) {
+    uint32_t slot;
+    if (!acquireSlot(slot))
+      return false;
+
+    slots[slot].clear();
+    publishSlot(slot, buildData(&message, &slots[slot]));
+    return true;
+  }
+
+  /**
+   * @brief Same as above for compile time schema messages (see schema.hpp)
+   */
+  template <typename M>
+    requires(!std::is_base_of_v<BaseMessageLogger, M>)
+  bool publish(M &message) {
+    uint32_t slot;
+    if (!acquireSlot(slot))
+      return false;
+
+    slots[slot].clear();
+    publishSlot(slot, message.build(&slots[slot]));
+    return true;
+  }
+
+  uint32_t publishedFrames() const { return published_frames.load(); }
+  uint32_t sentFrames() const { return sent_frames.load(); }
+  uint32_t droppedFrames() const { return dropped_frames.load(); }
+  uint32_t queuedFrames() const { return ready_slots.size(); }
+};
+
+} // namespace logger
+} // namespace vexmaps
@@ -0,0 +1,249 @@
+/**
+ * @file
+ * @brief Blocked frame of reference bit packing for 16 bit particle deltas
+ *
+ * Values are split into blocks of 128. Every block stores its minimum (the
+ * reference) and the bit width of the largest value minus the reference, then
+ * the values minus the reference using exactly that many bits:
+ *
+ * [width][reference, int16 LE][packed values]
+ *
+ * Full blocks use the SIMD-BP128 layout: value i goes to lane i % 8 of row
+ * i / 8, and the 16 rows are packed into width vectors of 8 16 bit lanes
+ * (16 * width bytes). Every width has its own fully unrolled (un)pack
+ * function, so there are no branches inside a block. The last partial block
+ * packs its values one after the other, LSB first, in (count * width + 7) / 8
+ * bytes.
+ */
+
+#pragma once
+
+#include "simd.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace vexmaps {
+namespace logger {
+namespace bitpack {
+
+constexpr size_t block_size = 128;
+
+// width and reference
+constexpr size_t block_header_size = 3;
+
+constexpr size_t max_size(size_t n) {
+  return (n + block_size - 1) / block_size * block_header_size + 2 * n;
+}
+
+namespace detail {
+
+constexpr int rows = block_size / 8;
+
+template <int W, int R>
+inline void packRow(const int16_t *in, simd::s16x8 ref, simd::s16x8 &acc,
+                    uint8_t *out) {
+  constexpr int word = R * W / 16;
+  constexpr int offset = R * W % 16;
+
+  simd::s16x8 v = simd::sub(simd::load_s16(in + 8 * R), ref);
+  if constexpr (offset == 0)
+    acc = v;
+  else
+    acc = simd::bit_or(acc, simd::shl<offset>(v));
+
+  if constexpr (offset + W >= 16) {
+    simd::store_bytes(out + 16 * word, acc);
+    // bits that did not fit start the next word
+    if constexpr (offset + W > 16)
+      acc = simd::shr<16 - offset>(v);
+  }
+}
+
+template <int W, int R>
+inline void unpackRow(const uint8_t *in, simd::s16x8 ref, int16_t *out) {
+  constexpr int word = R * W / 16;
+  constexpr int offset = R * W % 16;
+
+  simd::s16x8 v = simd::load_bytes(in + 16 * word);
+  if constexpr (offset != 0)
+    v = simd::shr<offset>(v);
+  if constexpr (offset + W > 16)
+    v = simd::bit_or(v, simd::shl<16 - offset>(
+                            simd::load_bytes(in + 16 * (word + 1))));
+  if constexpr (W < 16)
+    v = simd::bit_and(v, simd::dup_s16(static_cast<int16_t>((1 << W) - 1)));
+  simd::store_s16(out + 8 * R, simd::add(v, ref));
+}
+
+template <int W>
+inline void packBlock(const int16_t *in, int16_t reference, uint8_t *out) {
+  if constexpr (W > 0) {
+    simd::s16x8 ref = simd::dup_s16(reference);
+    simd::s16x8 acc = simd::zero_s16();
+    [&]<int... R>(std::integer_sequence<int, R...>) {
+      (packRow<W, R>(in, ref, acc, out), ...);
+    }(std::make_integer_sequence<int, rows>{});
+  }
+}
+
+template <int W>
+inline void unpackBlock(const uint8_t *in, int16_t reference, int16_t *out) {
+  simd::s16x8 ref = simd::dup_s16(reference);
+  if constexpr (W == 0) {
+    for (int r = 0; r < rows; r++)
+      simd::store_s16(out + 8 * r, ref);
+  } else {
+    [&]<int... R>(std::integer_sequence<int, R...>) {
+      (unpackRow<W, R>(in, ref, out), ...);
+    }(std::make_integer_sequence<int, rows>{});
+  }
+}
+
+using PackFunction = void (*)(const int16_t *, int16_t, uint8_t *);
+using UnpackFunction = void (*)(const uint8_t *, int16_t, int16_t *);
+
+template <int... W>
+constexpr std::array<PackFunction, 17>
+    make_pack_functions(std::integer_sequence<int, W...>) {
+  return {&packBlock<W>...};
+}
+
+template <int... W>
+constexpr std::array<UnpackFunction, 17>
+    make_unpack_functions(std::integer_sequence<int, W...>) {
+  return {&unpackBlock<W>...};
+}
+
+// indexed by width
+inline constexpr std::array<PackFunction, 17> pack_functions =
+    make_pack_functions(std::make_integer_sequence<int, 17>{});
+inline constexpr std::array<UnpackFunction, 17> unpack_functions =
+    make_unpack_functions(std::make_integer_sequence<int, 17>{});
+
+// minimum and bit width of count values
+inline std::pair<int16_t, int> blockRange(const int16_t *in, size_t count) {
+  int16_t low = in[0];
+  int16_t high = in[0];
+  size_t i = 0;
+  if (count >= 8) {
+    simd::s16x8 lows = simd::load_s16(in);
+    simd::s16x8 highs = lows;
+    for (i = 8; i + 8 <= count; i += 8) {
+      simd::s16x8 v = simd::load_s16(in + i);
+      lows = simd::min(lows, v);
+      highs = simd::max(highs, v);
+    }
+    int16_t tmp_low[8];
+    int16_t tmp_high[8];
+    simd::store_s16(tmp_low, lows);
+    simd::store_s16(tmp_high, highs);
+    for (int k = 0; k < 8; k++) {
+      low = std::min(low, tmp_low[k]);
+      high = std::max(high, tmp_high[k]);
+    }
+  }
+  for (; i < count; i++) {
+    low = std::min(low, in[i]);
+    high = std::max(high, in[i]);
+  }
+  return {low, std::bit_width(static_cast<uint16_t>(high - low))};
+}
+
+inline size_t packedSize(size_t count, int width) {
+  return count == block_size ? 16 * width : (count * width + 7) / 8;
+}
+
+} // namespace detail
+
+/**
+ * @brief Encodes n int16 values, returns the number of bytes written
+ *
+ * @param out needs max_size(n) bytes of room
+ */
+inline size_t encode(const int16_t *in, size_t n, uint8_t *out) {
+  uint8_t *start = out;
+  for (size_t block = 0; block < n; block += block_size) {
+    size_t count = std::min(block_size, n - block);
+    auto [reference, width] = detail::blockRange(in + block, count);
+
+    *out++ = static_cast<uint8_t>(width);
+    *out++ = static_cast<uint8_t>(reference);
+    *out++ = static_cast<uint8_t>(static_cast<uint16_t>(reference) >> 8);
+
+    if (count == block_size) {
+      detail::pack_functions[width](in + block, reference, out);
+    } else {
+      uint32_t bit_buffer = 0;
+      int bit_count = 0;
+      uint8_t *data = out;
+      for (size_t i = 0; i < count; i++) {
+        uint16_t v = in[block + i] - reference;
+        bit_buffer |= static_cast<uint32_t>(v) << bit_count;
+        bit_count += width;
+        while (bit_count >= 8) {
+          *data++ = static_cast<uint8_t>(bit_buffer);
+          bit_buffer >>= 8;
+          bit_count -= 8;
+        }
+      }
+      if (bit_count > 0)
+        *data++ = static_cast<uint8_t>(bit_buffer);
+    }
+    out += detail::packedSize(count, width);
+  }
+  return out - start;
+}
+
+/**
+ * @brief Number of bytes encode() will write for the same values
+ */
+inline size_t encoded_size(const int16_t *in, size_t n) {
+  size_t len = 0;
+  for (size_t block = 0; block < n; block += block_size) {
+    size_t count = std::min(block_size, n - block);
+    int width = detail::blockRange(in + block, count).second;
+    len += block_header_size + detail::packedSize(count, width);
+  }
+  return len;
+}
+
+/**
+ * @brief Decodes n int16 values, returns the number of bytes consumed
+ */
+inline size_t decode(const uint8_t *in, size_t n, int16_t *out) {
+  const uint8_t *start = in;
+  for (size_t block = 0; block < n; block += block_size) {
+    size_t count = std::min(block_size, n - block);
+    int width = std::min<int>(in[0], 16);
+    int16_t reference = static_cast<int16_t>(in[1] | (in[2] << 8));
+    in += block_header_size;
+
+    if (count == block_size) {
+      detail::unpack_functions[width](in, reference, out + block);
+    } else {
+      uint32_t bit_buffer = 0;
+      int bit_count = 0;
+      const uint8_t *data = in;
+      const uint32_t mask = (1u << width) - 1;
+      for (size_t i = 0; i < count; i++) {
+        while (bit_count < width) {
+          bit_buffer |= static_cast<uint32_t>(*data++) << bit_count;
+          bit_count += 8;
+        }
+        out[block + i] = static_cast<int16_t>(reference + (bit_buffer & mask));
+        bit_buffer >>= width;
+        bit_count -= width;
+      }
+    }
+    in += detail::packedSize(count, width);
+  }
+  return in - start;
+}
+
+} // namespace bitpack
+} // namespace logger
+} // namespace vexmaps
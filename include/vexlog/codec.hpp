@@ -0,0 +1,300 @@
+/**
+ * @file
+ * @brief Compression codecs used by LogSession, and a policy that picks one
+ * per frame from a time budget
+ *
+ * Every codec produces blocks that the receiver can decode knowing only the
+ * codec id stored in the frame flags (see frame.hpp). LZ4 and LZ4HC share the
+ * block format, so frames can switch between them without breaking the
+ * streamed history.
+ */
+
+#pragma once
+
+#include "frame.hpp"
+#include "lz4/lz4.h"
+#include "lz4/lz4hc.h"
+#include "platform.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace vexmaps {
+namespace logger {
+
+/**
+ * @brief Block compressor that can keep history between blocks.
+ *
+ * A stream starts with reset(), after which every compress() call may
+ * reference the blocks compressed since then, as long as they are still in
+ * memory right before the new block.
+ */
+class Codec {
+public:
+  virtual uint8_t id() const = 0;
+
+  /**
+   * @brief Forgets the history, the next block may reference history instead
+   * (the preset dictionary, or the end of the previous frames when switching
+   * codecs in the middle of a stream)
+   *
+   * @param preset history is the preset dictionary, which never changes, so
+   * the codec may keep it loaded between calls
+   */
+  virtual void reset(std::span<const char> history, bool preset = false) = 0;
+
+  // returns the compressed size, or 0 if it did not fit in capacity
+  virtual int compress(const char *src, int size, char *dst, int capacity) = 0;
+
+  /**
+   * @brief Moves the last (up to) max bytes of history to dst so the stream
+   * can continue from there, returns how many bytes were kept
+   */
+  virtual int saveHistory(char *dst, int max) = 0;
+
+  virtual int bound(int size) const { return LZ4_compressBound(size); }
+
+  virtual ~Codec() = default;
+};
+
+/**
+ * @brief Stores frames uncompressed, for when there is no CPU time to spare
+ */
+class NoneCodec : public Codec {
+private:
+  // the blocks seen since reset() still in memory, for saveHistory()
+  const char *history = nullptr;
+  int history_size = 0;
+
+public:
+  uint8_t id() const override { return frame::codec_none; }
+
+  void reset(std::span<const char> history, bool preset = false) override {
+    this->history = history.data();
+    history_size = history.size();
+  }
+
+  int compress(const char *src, int size, char *dst, int capacity) override {
+    if (size > capacity)
+      return 0;
+    std::memcpy(dst, src, size);
+    if (src != history + history_size) {
+      history = src;
+      history_size = 0;
+    }
+    history_size += size;
+    return size;
+  }
+
+  int saveHistory(char *dst, int max) override {
+    int kept = std::min(history_size, max);
+    std::memmove(dst, history + history_size - kept, kept);
+    history = dst;
+    history_size = kept;
+    return kept;
+  }
+
+  int bound(int size) const override { return size; }
+
+  ~NoneCodec() override = default;
+};
+
+/**
+ * @brief LZ4 fast, higher acceleration trades ratio for speed
+ */
+class LZ4Codec : public Codec {
+private:
+  LZ4_stream_t state;
+  int acceleration;
+
+  // state right after loading the preset dictionary, copying it is much
+  // cheaper than hashing the dictionary again for every frame
+  LZ4_stream_t preset_state;
+  std::span<const char> preset;
+
+public:
+  LZ4Codec(int acceleration = 1) : acceleration(acceleration) {
+    LZ4_initStream(&state, sizeof(state));
+  }
+
+  void setAcceleration(int acceleration) { this->acceleration = acceleration; }
+
+  uint8_t id() const override { return frame::codec_lz4; }
+
+  void reset(std::span<const char> history, bool preset = false) override {
+    if (history.empty()) {
+      LZ4_resetStream_fast(&state);
+    } else if (!preset) {
+      LZ4_loadDict(&state, history.data(), history.size());
+    } else {
+      if (history.data() != this->preset.data() ||
+          history.size() != this->preset.size()) {
+        LZ4_loadDict(&preset_state, history.data(), history.size());
+        this->preset = history;
+      }
+      std::memcpy(&state, &preset_state, sizeof(state));
+    }
+  }
+
+  int compress(const char *src, int size, char *dst, int capacity) override {
+    return LZ4_compress_fast_continue(&state, src, dst, size, capacity,
+                                      acceleration);
+  }
+
+  int saveHistory(char *dst, int max) override {
+    return LZ4_saveDict(&state, dst, max);
+  }
+
+  ~LZ4Codec() override = default;
+};
+
+/**
+ * @brief LZ4HC, much slower but smaller frames, decoded like LZ4
+ */
+class LZ4HCCodec : public Codec {
+private:
+  // about 256KB, so it lives on the heap
+  std::unique_ptr<LZ4_streamHC_t> state;
+  int level;
+
+public:
+  LZ4HCCodec(int level = LZ4HC_CLEVEL_DEFAULT)
+      : state(std::make_unique<LZ4_streamHC_t>()), level(level) {
+    LZ4_initStreamHC(state.get(), sizeof(*state));
+  }
+
+  void setLevel(int level) { this->level = level; }
+
+  uint8_t id() const override { return frame::codec_lz4hc; }
+
+  void reset(std::span<const char> history, bool preset = false) override {
+    LZ4_resetStreamHC_fast(state.get(), level);
+    if (!history.empty())
+      LZ4_loadDictHC(state.get(), history.data(), history.size());
+  }
+
+  int compress(const char *src, int size, char *dst, int capacity) override {
+    return LZ4_compress_HC_continue(state.get(), src, dst, size, capacity);
+  }
+
+  int saveHistory(char *dst, int max) override {
+    return LZ4_saveDictHC(state.get(), dst, max);
+  }
+
+  ~LZ4HCCodec() override = default;
+};
+
+/**
+ * @brief Picks the strongest codec whose expected compress time fits in a per
+ * frame budget.
+ *
+ * Expected times come from a running average of the measured time per KB of
+ * each codec. Codecs are only used once they have been measured, so call
+ * calibrate() with a typical frame before the first send, the first frames
+ * use the weakest codec until then. Regular frames keep a quarter of the
+ * budget as headroom for noise in the averages. Every probe_interval frames
+ * the next stronger codec is tried once if its expected time fits the whole
+ * budget, so it gets picked once its average drops below the headroom.
+ */
+class AdaptiveCodecPolicy {
+private:
+  // weakest first
+  std::vector<Codec *> codecs;
+  // running average of microseconds per KB, negative until measured
+  std::vector<float> cost;
+  uint32_t budget;
+  uint32_t probe_interval;
+  uint32_t frames = 0;
+  size_t selected = 0;
+
+  // time spent compressing the calibration sample with each codec
+  static constexpr uint64_t calibration_micros = 2000;
+
+  bool fits(size_t i, size_t raw_size, float budget) const {
+    return cost[i] >= 0 && cost[i] * raw_size / 1024 <= budget;
+  }
+
+public:
+  /**
+   * @param codecs ordered from the weakest (cheapest) to the strongest, they
+   * must stay alive as long as the policy
+   * @param budget microseconds a frame may spend compressing
+   */
+  AdaptiveCodecPolicy(std::vector<Codec *> codecs, uint32_t budget,
+                      uint32_t probe_interval = 32)
+      : codecs(std::move(codecs)), cost(this->codecs.size(), -1),
+        budget(budget), probe_interval(probe_interval) {
+    assert(!this->codecs.empty() && "policy needs at least one codec");
+  }
+
+  void setBudget(uint32_t budget) { this->budget = budget; }
+  uint32_t getBudget() const { return budget; }
+
+  /**
+   * @brief Measures every codec on sample, e.g. a frame built with
+   * buildData(), so none has to be tried blind during a match. Replaces
+   * earlier measurements.
+   *
+   * Resets the codecs, so call it before the session sends its first frame
+   * or restart streaming afterwards (LogSession::setStreaming)
+   */
+  void calibrate(std::span<const char> sample) {
+    if (sample.empty())
+      return;
+    std::vector<char> out(std::max<size_t>(
+        LZ4_compressBound(sample.size()), sample.size()));
+    for (size_t i = 0; i < codecs.size(); i++) {
+      uint64_t start = platform::micros();
+      uint64_t elapsed = 0;
+      size_t runs = 0;
+      // repeated until it takes long enough for the clock to resolve
+      do {
+        codecs[i]->reset({});
+        codecs[i]->compress(sample.data(), sample.size(), out.data(),
+                            out.size());
+        runs++;
+        elapsed = platform::micros() - start;
+      } while (elapsed < calibration_micros);
+      cost[i] = 1024.0f * elapsed / (runs * sample.size());
+    }
+  }
+
+  /**
+   * @brief Codec to use for a frame of raw_size bytes
+   */
+  Codec &select(size_t raw_size) {
+    // the weakest codec is used even if it does not fit
+    selected = 0;
+    for (size_t i = 1; i < codecs.size(); i++) {
+      if (fits(i, raw_size, budget * 0.75f))
+        selected = i;
+    }
+    if (++frames % probe_interval == 0 && selected + 1 < codecs.size() &&
+        fits(selected + 1, raw_size, budget))
+      selected++;
+    return *codecs[selected];
+  }
+
+  /**
+   * @brief Feeds back how long the last selected codec took
+   */
+  void record(size_t raw_size, uint32_t micros) {
+    if (raw_size == 0)
+      return;
+    float sample = 1024.0f * micros / raw_size;
+    float &average = cost[selected];
+    average = average < 0 ? sample : average + (sample - average) / 8;
+  }
+
+  /**
+   * @brief Expected microseconds per KB of codec i, negative if never
+   * measured
+   */
+  float expectedCost(size_t i) const { return cost[i]; }
+};
+
+} // namespace logger
+} // namespace vexmaps
@@ -0,0 +1,372 @@
+/**
+ * @file
+ * @brief LZ4 dictionary trained on recorded vexlog messages
+ *
+ * Generated by js_parser/train_dictionary.js, do not edit. Pass it to
+ * LogSession::setDictionary and FrameDecoder::addDictionary.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace vexmaps {
+namespace logger {
+namespace dictionary {
+
+constexpr uint32_t id = 0x3e369382;
+
+inline constexpr unsigned char data[] = {
+    0x09, 0x13, 0x73, 0x64, 0xb5, 0x3f, 0x15, 0xde, 0x1c, 0xbf, 0xcf, 0xd2,
+    0x57, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x52, 0x54, 0xd1, 0x42,
+    0x16, 0x22, 0x16, 0xd4, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0xaf, 0x4a, 0x77, 0x43, 0x16, 0x17, 0x16, 0xe6, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x01, 0x72, 0xa9, 0x44, 0x16, 0x23, 0x16, 0xde,
+    0x01, 0x14, 0x70, 0x42, 0xad, 0xa1, 0xbe, 0xd0, 0x38, 0x19, 0x40, 0x70,
+    0x42, 0x0d, 0x16, 0x00, 0x12, 0x2a, 0xdb, 0xd0, 0x44, 0x16, 0x0a, 0x16,
+    0x96, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x97, 0x05, 0x34,
+    0x43, 0x16, 0x02, 0x16, 0xf3, 0x01, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x02,
+    0x12, 0xf2, 0xf0, 0x51, 0x42, 0x16, 0x0e, 0x16, 0x4f, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x03, 0x12, 0xb0, 0x0f, 0xcd, 0x44, 0xd8, 0x36, 0x16, 0x97,
+    0x11, 0x13, 0x80, 0xbc, 0x2a, 0xbd, 0x16, 0x58, 0x97, 0xbf, 0x00, 0x4b,
+    0x0d, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xd9, 0x85, 0xea, 0x44,
+    0x16, 0x27, 0x16, 0xa9, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0x12, 0x97, 0x5b, 0x44, 0x16, 0x1b, 0x16, 0xd1, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x3c, 0x01, 0xcb, 0x44, 0x16, 0x3b, 0x16, 0x91,
+    0x2d, 0xbe, 0x30, 0x8e, 0x04, 0x40, 0x70, 0x42, 0x0c, 0x16, 0x00, 0x12,
+    0xd7, 0x84, 0x54, 0x44, 0x16, 0x1d, 0x16, 0x2f, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x01, 0x12, 0xfb, 0xf5, 0xd7, 0x44, 0x16, 0x10, 0x16, 0xe1, 0x01,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xbe, 0xf1, 0x15, 0x43, 0x16,
+    0x10, 0x16, 0xd3, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x36,
+    0xa1, 0x32, 0x43, 0x16, 0xbf, 0xfc, 0xaf, 0x73, 0x3e, 0x70, 0x42, 0x0d,
+    0x16, 0x00, 0x12, 0x08, 0x94, 0x4a, 0x44, 0x16, 0x0d, 0x16, 0x80, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x14, 0x35, 0xfa, 0x44, 0x16,
+    0x38, 0x16, 0xd5, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x79,
+    0xe0, 0xa8, 0x44, 0x16, 0x0a, 0x16, 0xe6, 0x02, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x03, 0x12, 0xc0, 0xeb, 0x85, 0x44, 0x16, 0x95, 0x3f, 0x91, 0x33,
+    0x84, 0x3f, 0x70, 0x42, 0x0c, 0x16, 0x00, 0x12, 0x45, 0xb0, 0x14, 0x44,
+    0x16, 0x29, 0x16, 0x7d, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x7b,
+    0x56, 0x98, 0x44, 0x16, 0x1d, 0x16, 0xc5, 0x01, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x02, 0x12, 0x32, 0xf1, 0xd3, 0x44, 0x16, 0x1a, 0x16, 0xbc, 0x01,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x75, 0x5a, 0xf6, 0x44, 0x16,
+    0x9b, 0xbe, 0xaa, 0x0d, 0xc2, 0x40, 0x70, 0x42, 0x0c, 0x16, 0x00, 0x12,
+    0x1c, 0x5b, 0x39, 0x42, 0x16, 0x3b, 0x16, 0x7e, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x01, 0x12, 0x40, 0x33, 0xbc, 0x44, 0x16, 0x06, 0x16, 0xe3, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x09, 0x51, 0x11, 0x44, 0x16,
+    0x38, 0x16, 0xb7, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x5d,
+    0x94, 0xa7, 0x44, 0x16, 0x07, 0x13, 0x6e, 0x6c, 0x07, 0xbf, 0xe0, 0x74,
+    0x92, 0x3c, 0x0a, 0xbb, 0x67, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0xfa, 0xcd, 0x42, 0x43, 0x16, 0x28, 0x16, 0xd6, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0x84, 0xce, 0x92, 0x44, 0x16, 0x3d, 0x16, 0xc8,
+    0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x00, 0x20, 0x1d, 0x42,
+    0x16, 0x11, 0x16, 0xc1, 0x01, 0x14, 0x70, 0x42, 0x85, 0xbf, 0x46, 0x8e,
+    0xad, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x28, 0x21, 0xbb, 0x43,
+    0x16, 0x37, 0x16, 0xd9, 0x01, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x01, 0x12,
+    0xd9, 0xba, 0x95, 0x44, 0x16, 0x3f, 0x16, 0x5d, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x02, 0x12, 0x52, 0x71, 0x62, 0x44, 0x16, 0x0f, 0x16, 0xac, 0x01,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x03, 0xb3, 0x39, 0x44, 0x16,
+    0x14, 0x13, 0x00, 0x29, 0xf1, 0x3b, 0xdc, 0x64, 0x8e, 0x3e, 0xe0, 0x25,
+    0x7e, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x80, 0xf4, 0xf1, 0x44,
+    0x16, 0x3f, 0x16, 0xd0, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0x1e, 0xf7, 0x6a, 0x44, 0x16, 0x23, 0x16, 0xcb, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x1b, 0x3b, 0x33, 0x44, 0x16, 0x05, 0x16, 0xbe,
+    0x02, 0x14, 0x70, 0x42, 0x05, 0x13, 0xe5, 0x16, 0x8e, 0x3f, 0xda, 0x15,
+    0x9d, 0x3f, 0x3a, 0xe3, 0x21, 0x3f, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0x21, 0x47, 0xea, 0x44, 0x16, 0x0f, 0x16, 0xf6, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0xd4, 0xa8, 0xe2, 0x44, 0x16, 0x16, 0x16, 0xc1,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x87, 0x26, 0x62, 0x43,
+    0x16, 0x24, 0x16, 0xb6, 0x02, 0x14, 0x70, 0x42, 0xa9, 0x16, 0x13, 0x7d,
+    0xdc, 0x6d, 0x3f, 0xae, 0x07, 0xb3, 0x3e, 0x04, 0xd2, 0x80, 0x40, 0x70,
+    0x42, 0x0d, 0x16, 0x00, 0x12, 0xcd, 0x8d, 0x8f, 0x43, 0x16, 0x2d, 0x16,
+    0xbb, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x86, 0x59, 0xd9,
+    0x44, 0x16, 0x2a, 0x16, 0xba, 0x01, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x02,
+    0x12, 0xd6, 0x90, 0xd3, 0x43, 0x16, 0x28, 0x16, 0x71, 0x14, 0x70, 0x42,
+    0x63, 0xc8, 0x3e, 0x64, 0xa1, 0x11, 0x3e, 0x70, 0x42, 0x0c, 0x16, 0x00,
+    0x12, 0x89, 0x83, 0x96, 0x44, 0x16, 0x28, 0x16, 0x27, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0xa0, 0x8d, 0x91, 0x44, 0x16, 0x1b, 0x16, 0x9c,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x2d, 0xa5, 0xea, 0x44,
+    0x16, 0x2d, 0x16, 0x85, 0x03, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x03, 0x12,
+    0x8e, 0x9c, 0x2b, 0x44, 0x05, 0x13, 0x59, 0x5a, 0x9a, 0xbe, 0x74, 0x89,
+    0x6b, 0xbf, 0xd6, 0x61, 0x96, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0x40, 0xe4, 0x56, 0x43, 0x16, 0x33, 0x16, 0xf5, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0xc6, 0x4e, 0xc9, 0x42, 0x16, 0x36, 0x16, 0x80,
+    0x03, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xa6, 0x32, 0xf0, 0x44,
+    0x16, 0x33, 0x16, 0xc5, 0x02, 0x14, 0x70, 0x42, 0xed, 0x0a, 0x13, 0x52,
+    0xd1, 0x92, 0x3f, 0x92, 0x03, 0xbe, 0x3e, 0x84, 0xc9, 0xd9, 0x3f, 0x70,
+    0x42, 0x0c, 0x16, 0x00, 0x12, 0x69, 0x71, 0x78, 0x44, 0x16, 0x13, 0x16,
+    0x61, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x28, 0x9d, 0xc0, 0x44,
+    0x16, 0x2b, 0x16, 0xac, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0x8b, 0x3b, 0xa0, 0x44, 0x16, 0x0a, 0x16, 0x8c, 0x01, 0x14, 0x70, 0x42,
+    0xbe, 0x8f, 0x36, 0x08, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x9b,
+    0x5b, 0x95, 0x44, 0x16, 0x26, 0x16, 0x97, 0x02, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x01, 0x12, 0x47, 0x01, 0xf9, 0x43, 0x16, 0x23, 0x16, 0xbf, 0x01,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xdd, 0x36, 0xf3, 0x44, 0x16,
+    0x3f, 0x16, 0x9a, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0xf7,
+    0x38, 0xb8, 0x42, 0x16, 0x3d, 0xd4, 0x18, 0xaa, 0x40, 0x70, 0x42, 0x0d,
+    0x16, 0x00, 0x12, 0x3c, 0xae, 0x04, 0x44, 0x16, 0x1c, 0x16, 0xc6, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x93, 0x0c, 0xd1, 0x43, 0x16,
+    0x36, 0x16, 0xf4, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xa2,
+    0x3e, 0x94, 0x44, 0x16, 0x24, 0x16, 0x84, 0x02, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x03, 0x12, 0x5f, 0x4d, 0x72, 0x44, 0x16, 0xbd, 0xea, 0xa1, 0x89,
+    0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x6a, 0x97, 0x62, 0x42, 0x16,
+    0x34, 0x16, 0xd7, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0xe0,
+    0xf2, 0xea, 0x44, 0x16, 0x28, 0x16, 0xfb, 0x01, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x02, 0x12, 0x77, 0x02, 0x7f, 0x44, 0x16, 0x20, 0x16, 0xf0, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x21, 0xe5, 0xee, 0x42, 0x16,
+    0xd2, 0x17, 0x13, 0x2b, 0xe6, 0x7c, 0x3f, 0x6a, 0x15, 0x66, 0xbe, 0x21,
+    0xb3, 0xc7, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x4d, 0x21, 0x1e,
+    0x44, 0x16, 0x0b, 0x16, 0x85, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01,
+    0x12, 0x46, 0xaa, 0xf6, 0x44, 0x16, 0x3f, 0x16, 0xdf, 0x01, 0x14, 0x70,
+    0x42, 0x0c, 0x16, 0x02, 0x12, 0xae, 0xac, 0x43, 0x44, 0x16, 0x13, 0x16,
+    0x35, 0x14, 0x70, 0x42, 0xcf, 0x6c, 0xbf, 0x21, 0x62, 0xb0, 0x40, 0x70,
+    0x42, 0x0d, 0x16, 0x00, 0x12, 0xef, 0x08, 0x31, 0x43, 0x16, 0x34, 0x16,
+    0xb0, 0x01, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x01, 0x12, 0xf1, 0x0c, 0xc8,
+    0x44, 0x16, 0x35, 0x16, 0x20, 0x15, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0x70, 0x32, 0x28, 0x44, 0x16, 0x21, 0x16, 0xd9, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x03, 0x12, 0xfc, 0x33, 0xf2, 0x44, 0xda, 0x0d, 0x13, 0x1b,
+    0xd0, 0x86, 0xbe, 0x00, 0x42, 0xcc, 0xbc, 0xd9, 0x29, 0x50, 0x40, 0x70,
+    0x42, 0x0d, 0x16, 0x00, 0x12, 0xe4, 0xf5, 0xbb, 0x44, 0x16, 0x08, 0x16,
+    0x9e, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0xd2, 0xd3, 0xb6,
+    0x44, 0x16, 0x2f, 0x16, 0xef, 0x02, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x02,
+    0x12, 0x4f, 0x20, 0x54, 0x44, 0x16, 0x16, 0x16, 0x46, 0x14, 0x70, 0x42,
+    0xb8, 0x02, 0x13, 0x4e, 0xaa, 0xfd, 0x3e, 0xe4, 0x99, 0x60, 0xbf, 0x40,
+    0x14, 0x95, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x49, 0xed, 0xfd,
+    0x43, 0x16, 0x02, 0x16, 0xc3, 0x01, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x01,
+    0x12, 0x1c, 0x15, 0x70, 0x44, 0x16, 0x2a, 0x16, 0x22, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x98, 0x9f, 0xa6, 0x44, 0x16, 0x0e, 0x16, 0xc3,
+    0x01, 0x14, 0x70, 0x42, 0x19, 0x13, 0x9c, 0x6a, 0x13, 0xbf, 0xc0, 0x29,
+    0x5b, 0xbf, 0xab, 0xe6, 0x98, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0x01, 0xe8, 0xad, 0x44, 0x16, 0x01, 0x16, 0x9d, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0xc4, 0xf5, 0x3a, 0x44, 0x16, 0x2f, 0x16, 0xa2,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xd3, 0x56, 0xd4, 0x44,
+    0x16, 0x31, 0x16, 0xa0, 0x01, 0x14, 0x70, 0x42, 0x82, 0x17, 0x13, 0x26,
+    0xd9, 0x58, 0x3f, 0x90, 0x43, 0x84, 0xbf, 0x58, 0x8b, 0x42, 0x3f, 0x70,
+    0x42, 0x0c, 0x16, 0x00, 0x12, 0x66, 0x90, 0x96, 0x44, 0x16, 0x0f, 0x16,
+    0x15, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x2a, 0xa4, 0xa8, 0x44,
+    0x16, 0x31, 0x16, 0xb8, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0xce, 0x64, 0x89, 0x44, 0x16, 0x2e, 0x16, 0xd3, 0x01, 0x14, 0x70, 0x42,
+    0x10, 0x13, 0x1c, 0x23, 0x95, 0xbf, 0x9c, 0x82, 0x94, 0x3f, 0x64, 0x25,
+    0x3e, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xda, 0xd8, 0x8b, 0x44,
+    0x16, 0x32, 0x16, 0xf2, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0xa8, 0x0a, 0xf6, 0x44, 0x16, 0x04, 0x16, 0xa2, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x4a, 0x82, 0x3b, 0x44, 0x16, 0x21, 0x16, 0xf9,
+    0x02, 0x14, 0x70, 0x42, 0x16, 0x84, 0x43, 0x16, 0xc8, 0x02, 0x13, 0x00,
+    0xd6, 0x24, 0x3b, 0xc0, 0x09, 0x8d, 0x3d, 0x56, 0xd3, 0xac, 0x40, 0x70,
+    0x42, 0x0d, 0x16, 0x00, 0x12, 0xf4, 0x15, 0xaa, 0x44, 0x16, 0x35, 0x16,
+    0x94, 0x02, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x01, 0x12, 0xe3, 0x27, 0x43,
+    0x43, 0x16, 0x0d, 0x16, 0x0f, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0x2b, 0x17, 0x7e, 0x43, 0x16, 0x1b, 0x16, 0xc8, 0x0b, 0x13, 0xdc, 0xd2,
+    0x7e, 0xbe, 0x9f, 0xfc, 0x2b, 0xbf, 0xc6, 0xe2, 0x70, 0x40, 0x70, 0x42,
+    0x0d, 0x16, 0x00, 0x12, 0x53, 0xfc, 0x2e, 0x44, 0x16, 0x0f, 0x16, 0x8a,
+    0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x02, 0x64, 0xd9, 0x43,
+    0x16, 0x10, 0x16, 0x8c, 0x03, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0xf5, 0x70, 0xf8, 0x44, 0x16, 0x0b, 0x16, 0xa3, 0x01, 0x14, 0x70, 0x42,
+    0x3d, 0xe7, 0xd3, 0x99, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xce,
+    0x1e, 0x8a, 0x44, 0x16, 0x24, 0x16, 0xcd, 0x01, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x01, 0x12, 0x4a, 0x8d, 0xaa, 0x44, 0x16, 0x06, 0x16, 0xfe, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xd2, 0x1d, 0x4e, 0x44, 0x16,
+    0x31, 0x16, 0xb9, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0xed,
+    0xe5, 0x5a, 0x44, 0x16, 0x95, 0x0d, 0x13, 0xfd, 0xac, 0x0b, 0x3f, 0x38,
+    0xeb, 0x16, 0x3f, 0x80, 0x9c, 0x77, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00,
+    0x12, 0xfb, 0xdc, 0x30, 0x44, 0x16, 0x36, 0x16, 0xc2, 0x01, 0x14, 0x70,
+    0x42, 0x0c, 0x16, 0x01, 0x12, 0x38, 0xa2, 0xc6, 0x43, 0x16, 0x12, 0x16,
+    0x6a, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x19, 0x5f, 0x71, 0x44,
+    0x16, 0x23, 0x16, 0x94, 0x01, 0x14, 0x70, 0x42, 0xbe, 0x72, 0x02, 0x11,
+    0x3f, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xfa, 0xef, 0x92, 0x43, 0x16,
+    0x04, 0x16, 0xaa, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x70,
+    0xe2, 0x3b, 0x43, 0x16, 0x07, 0x16, 0x8d, 0x03, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x02, 0x12, 0x8f, 0xdd, 0xef, 0x43, 0x16, 0x19, 0x16, 0xbd, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0xac, 0x5c, 0x9c, 0x43, 0x16,
+    0x88, 0x14, 0x13, 0xcd, 0xcd, 0x9a, 0x3f, 0x5e, 0x7a, 0x84, 0x3f, 0x0f,
+    0xa3, 0xab, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x2b, 0xa8, 0xbe,
+    0x44, 0x16, 0x2a, 0x16, 0xe5, 0x01, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x01,
+    0x12, 0xb0, 0x6e, 0xc4, 0x44, 0x16, 0x1d, 0x16, 0x05, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x0e, 0xc4, 0xf8, 0x44, 0x16, 0x25, 0x16, 0xb4,
+    0x02, 0x14, 0x70, 0x42, 0xc8, 0x0f, 0x13, 0x69, 0x08, 0x38, 0xbf, 0x1e,
+    0xb8, 0x0f, 0x3f, 0x14, 0xe8, 0x46, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00,
+    0x12, 0x24, 0xb2, 0xa0, 0x44, 0x16, 0x19, 0x16, 0xd6, 0x02, 0x14, 0x70,
+    0x42, 0x0c, 0x16, 0x01, 0x12, 0x12, 0xd6, 0xe0, 0x44, 0x16, 0x36, 0x16,
+    0x10, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x0c, 0xea, 0xbb, 0x44,
+    0x16, 0x25, 0x16, 0xc0, 0x02, 0x14, 0x70, 0x42, 0x16, 0xd1, 0x55, 0x16,
+    0xd1, 0x07, 0x13, 0xae, 0x6d, 0xaa, 0x3e, 0x38, 0x50, 0xe0, 0x3d, 0x8d,
+    0x77, 0xa8, 0x40, 0x70, 0x42, 0x0c, 0x16, 0x00, 0x12, 0x5c, 0xd1, 0xae,
+    0x44, 0x16, 0x2b, 0x16, 0x6e, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0x9d, 0xa3, 0x67, 0x44, 0x16, 0x0f, 0x16, 0x8e, 0x03, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x40, 0x35, 0x38, 0x44, 0x16, 0x3e, 0x16, 0xc9,
+    0x02, 0x13, 0x84, 0x01, 0xaa, 0xbf, 0xf4, 0xcb, 0x2a, 0xbf, 0x25, 0x60,
+    0xa2, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x2c, 0xf8, 0x36, 0x43,
+    0x16, 0x0a, 0x16, 0xcd, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0xbe, 0xbb, 0x98, 0x43, 0x16, 0x0f, 0x16, 0xa8, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x31, 0x04, 0x37, 0x43, 0x16, 0x20, 0x16, 0x8d,
+    0x02, 0x14, 0x70, 0x42, 0x06, 0x13, 0x7e, 0xac, 0x98, 0x3e, 0x14, 0x69,
+    0x92, 0xbf, 0xb1, 0x51, 0x0b, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0x54, 0x32, 0x72, 0x43, 0x16, 0x02, 0x16, 0xcf, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0x3c, 0x55, 0x98, 0x43, 0x16, 0x1e, 0x16, 0x89,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xe4, 0xed, 0xae, 0x44,
+    0x16, 0x1a, 0x16, 0x90, 0x02, 0x14, 0x70, 0x42, 0x07, 0x13, 0xf6, 0x68,
+    0x8c, 0x3f, 0x92, 0x46, 0xa5, 0x3e, 0xd4, 0xfc, 0xb5, 0x40, 0x70, 0x42,
+    0x0d, 0x16, 0x00, 0x12, 0x84, 0xba, 0xd2, 0x44, 0x16, 0x30, 0x16, 0xb1,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0xa7, 0xf4, 0xe7, 0x44,
+    0x16, 0x37, 0x16, 0xb5, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0xb6, 0x38, 0x58, 0x42, 0x16, 0x39, 0x16, 0xcb, 0x01, 0x14, 0x70, 0x42,
+    0x15, 0x13, 0xca, 0x66, 0x96, 0x3f, 0x2d, 0xa0, 0x2d, 0xbf, 0x24, 0xfc,
+    0x73, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x57, 0xec, 0xa1, 0x44,
+    0x16, 0x35, 0x16, 0x91, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0x78, 0x33, 0x8c, 0x44, 0x16, 0x08, 0x16, 0x90, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x07, 0x1d, 0xfa, 0x44, 0x16, 0x33, 0x16, 0xa7,
+    0x02, 0x14, 0x70, 0x42, 0x07, 0x13, 0xd4, 0xde, 0x4d, 0x3f, 0xaa, 0xb6,
+    0x89, 0xbe, 0xcb, 0x2f, 0x3a, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0x58, 0x30, 0xa8, 0x43, 0x16, 0x29, 0x16, 0x84, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0xc5, 0xa3, 0xcc, 0x44, 0x16, 0x1d, 0x16, 0x9f,
+    0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x43, 0x1a, 0x8d, 0x44,
+    0x16, 0x0b, 0x16, 0xfa, 0x02, 0x14, 0x70, 0x42, 0x16, 0x9c, 0x16, 0x13,
+    0x5b, 0x1a, 0xae, 0xbf, 0x74, 0xdd, 0xda, 0xbe, 0x9d, 0x1b, 0x1f, 0x40,
+    0x70, 0x42, 0x0c, 0x16, 0x00, 0x12, 0x27, 0x4c, 0xb8, 0x44, 0x16, 0x24,
+    0x16, 0x09, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x92, 0xc8, 0x14,
+    0x44, 0x16, 0x2e, 0x16, 0x83, 0x03, 0x15, 0x70, 0x42, 0x0c, 0x16, 0x02,
+    0x12, 0x15, 0xad, 0xa7, 0x43, 0x16, 0x36, 0x16, 0x63, 0x14, 0x70, 0x42,
+    0xf5, 0x11, 0x13, 0xba, 0x0e, 0x1e, 0xbf, 0x94, 0x92, 0xaa, 0xbf, 0x1d,
+    0x53, 0xbb, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x0e, 0xe7, 0x99,
+    0x44, 0x16, 0x08, 0x16, 0x9e, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01,
+    0x12, 0xf8, 0xbc, 0x1f, 0x43, 0x16, 0x25, 0x16, 0xf1, 0x01, 0x14, 0x70,
+    0x42, 0x0c, 0x16, 0x02, 0x12, 0x73, 0x4b, 0x91, 0x44, 0x16, 0x2a, 0x16,
+    0x31, 0x14, 0x70, 0x42, 0xb8, 0xbe, 0xbc, 0xbf, 0x5e, 0x40, 0x70, 0x42,
+    0x0c, 0x16, 0x00, 0x12, 0x8f, 0xf8, 0xe0, 0x44, 0x16, 0x1a, 0x16, 0x65,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x29, 0x62, 0x16, 0x44, 0x16,
+    0x17, 0x16, 0xd7, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x97,
+    0xe8, 0x42, 0x43, 0x16, 0x06, 0x16, 0xb7, 0x01, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x03, 0x12, 0xd9, 0x8c, 0xb3, 0x44, 0x16, 0xc6, 0xb2, 0x3f, 0xdc,
+    0x51, 0x93, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xf5, 0xfb, 0x94,
+    0x43, 0x16, 0x02, 0x16, 0xf7, 0x02, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x01,
+    0x12, 0x7e, 0x77, 0xb7, 0x44, 0x16, 0x15, 0x16, 0x5e, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0xe2, 0x04, 0x65, 0x44, 0x16, 0x22, 0x16, 0xc3,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x5a, 0xbd, 0xcb, 0x43,
+    0x0f, 0x13, 0x4f, 0xb8, 0x44, 0x3f, 0x42, 0x21, 0xf0, 0xbe, 0x49, 0x3e,
+    0x8b, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xd6, 0x42, 0xd2, 0x44,
+    0x16, 0x07, 0x16, 0xec, 0x02, 0x15, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0xa6, 0x32, 0xab, 0x43, 0x16, 0x03, 0x16, 0x92, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x29, 0xfd, 0x78, 0x44, 0x16, 0x01, 0x16, 0x9b,
+    0x01, 0x14, 0x70, 0x42, 0x3f, 0xaf, 0xab, 0x86, 0x40, 0x70, 0x42, 0x0d,
+    0x16, 0x00, 0x12, 0xc6, 0xa5, 0x63, 0x44, 0x16, 0x0b, 0x16, 0xc0, 0x01,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x48, 0xb9, 0x34, 0x44, 0x16,
+    0x39, 0x16, 0xee, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x1f,
+    0x89, 0xd2, 0x43, 0x16, 0x17, 0x16, 0xe2, 0x01, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x03, 0x12, 0xd1, 0x00, 0xb7, 0x44, 0x16, 0xbe, 0x78, 0xa0, 0xba,
+    0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x6e, 0x3b, 0xe8, 0x44, 0x16,
+    0x17, 0x16, 0x8d, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x85,
+    0x0f, 0xf6, 0x44, 0x16, 0x25, 0x16, 0xea, 0x02, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x02, 0x12, 0x7f, 0x92, 0xe9, 0x44, 0x16, 0x0b, 0x16, 0xf9, 0x01,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x8f, 0x7f, 0x04, 0x44, 0x16,
+    0x15, 0x13, 0x94, 0x71, 0xaa, 0x3f, 0xf6, 0xaa, 0x8d, 0xbf, 0xc2, 0xa0,
+    0x78, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xe4, 0xd5, 0xd3, 0x44,
+    0x16, 0x25, 0x16, 0xdc, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0x4e, 0x05, 0xde, 0x44, 0x16, 0x17, 0x16, 0x86, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x9b, 0xc0, 0x20, 0x43, 0x16, 0x2b, 0x16, 0x83,
+    0x03, 0x14, 0x70, 0x42, 0x07, 0x13, 0xbb, 0x26, 0x76, 0x3f, 0xe2, 0xe9,
+    0xb7, 0x3e, 0xc8, 0x48, 0xa8, 0x3d, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0x2e, 0xb2, 0xf6, 0x44, 0x16, 0x08, 0x16, 0x81, 0x03, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0xc8, 0xe8, 0x1f, 0x44, 0x16, 0x17, 0x16, 0x8f,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xf7, 0x78, 0x3f, 0x44,
+    0x16, 0x29, 0x16, 0xaa, 0x01, 0x14, 0x70, 0x42, 0xe6, 0x01, 0x16, 0x97,
+    0x08, 0x13, 0x31, 0x37, 0xab, 0xbf, 0xc8, 0x6c, 0x53, 0x3e, 0xa9, 0xcb,
+    0x45, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xa6, 0x44, 0x5e, 0x44,
+    0x16, 0x0e, 0x16, 0xab, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0xcc, 0x7a, 0xa4, 0x44, 0x16, 0x16, 0x16, 0x98, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0xc5, 0x53, 0xa1, 0x44, 0x16, 0x1c, 0x16, 0xdf,
+    0xd6, 0x01, 0x16, 0x91, 0x09, 0x13, 0xc6, 0x55, 0x2d, 0xbf, 0xb1, 0x0a,
+    0xaa, 0xbe, 0x38, 0x5d, 0x94, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0xc4, 0x4e, 0xf5, 0x44, 0x16, 0x2b, 0x16, 0x99, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0x2d, 0x32, 0xef, 0x44, 0x16, 0x3e, 0x16, 0xe7,
+    0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x8e, 0x45, 0x88, 0x43,
+    0x16, 0x28, 0x16, 0xe3, 0x82, 0x02, 0x16, 0xc2, 0x05, 0x13, 0x88, 0x54,
+    0x63, 0xbf, 0x2f, 0xbd, 0xac, 0x3f, 0x1e, 0xa8, 0x8a, 0x40, 0x70, 0x42,
+    0x0d, 0x16, 0x00, 0x12, 0x49, 0x9b, 0x98, 0x43, 0x16, 0x38, 0x16, 0xda,
+    0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x93, 0x73, 0x86, 0x44,
+    0x16, 0x24, 0x16, 0xae, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0xf2, 0xe3, 0x90, 0x44, 0x16, 0x04, 0x16, 0xc6, 0x08, 0x13, 0x00, 0x65,
+    0xcd, 0x3e, 0xdb, 0x5e, 0x72, 0xbf, 0x5b, 0x83, 0xa3, 0x40, 0x70, 0x42,
+    0x0d, 0x16, 0x00, 0x12, 0x6a, 0xcf, 0xd9, 0x42, 0x16, 0x16, 0x16, 0xbe,
+    0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0xa9, 0x5c, 0x6d, 0x44,
+    0x16, 0x3b, 0x16, 0xcc, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12,
+    0xa8, 0x13, 0xe2, 0x44, 0x16, 0x0b, 0x16, 0xe1, 0x02, 0x14, 0x70, 0x42,
+    0x48, 0x9d, 0xbf, 0x1a, 0x19, 0x4b, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00,
+    0x12, 0xe3, 0xc0, 0xd4, 0x44, 0x16, 0x3c, 0x16, 0xa7, 0x01, 0x14, 0x70,
+    0x42, 0x0d, 0x16, 0x01, 0x12, 0xec, 0x4c, 0x73, 0x43, 0x16, 0x23, 0x16,
+    0x8c, 0x02, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x02, 0x12, 0x8b, 0xca, 0x93,
+    0x44, 0x16, 0x38, 0x16, 0x5b, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12,
+    0xfd, 0x6a, 0xdb, 0x44, 0xbf, 0x65, 0xd6, 0x02, 0x40, 0x70, 0x42, 0x0d,
+    0x16, 0x00, 0x12, 0x89, 0x05, 0xc9, 0x42, 0x16, 0x0a, 0x16, 0x82, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x5f, 0x3b, 0xad, 0x44, 0x16,
+    0x0e, 0x16, 0x99, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x89,
+    0x05, 0xdc, 0x44, 0x16, 0x22, 0x16, 0x95, 0x02, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x03, 0x12, 0x89, 0x73, 0xba, 0x43, 0x16, 0x3d, 0x5e, 0x2e, 0x84,
+    0x3f, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xff, 0x82, 0xf4, 0x44, 0x16,
+    0x33, 0x16, 0xdb, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12, 0x5b,
+    0xf7, 0x2d, 0x43, 0x16, 0x18, 0x16, 0xec, 0x01, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x02, 0x12, 0x5d, 0x01, 0x34, 0x44, 0x16, 0x0b, 0x16, 0xa1, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x41, 0xb6, 0x9e, 0x44, 0x16,
+    0x0e, 0x13, 0xb0, 0x16, 0x37, 0x3d, 0x10, 0x67, 0x08, 0x3f, 0x82, 0x13,
+    0xa0, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xd0, 0xdb, 0xf5, 0x43,
+    0x16, 0x3d, 0x16, 0x82, 0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0x04, 0x72, 0xfc, 0x44, 0x16, 0x0f, 0x16, 0xff, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0x5c, 0x9b, 0xb0, 0x44, 0x16, 0x36, 0x16, 0x87,
+    0x03, 0x14, 0x70, 0x42, 0x16, 0x13, 0x6f, 0x5c, 0xc1, 0xbe, 0x1c, 0x2e,
+    0x19, 0xbf, 0x0d, 0x54, 0x61, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0x39, 0x04, 0xe3, 0x44, 0x16, 0x11, 0x16, 0x93, 0x02, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0x7b, 0x35, 0x32, 0x44, 0x16, 0x3f, 0x16, 0xfa,
+    0x01, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0xe1, 0xe1, 0x91, 0x44,
+    0x16, 0x04, 0x16, 0xd2, 0x02, 0x14, 0x70, 0x42, 0xa1, 0x89, 0x3f, 0x6f,
+    0xd0, 0xf5, 0x3e, 0x70, 0x42, 0x0c, 0x16, 0x00, 0x12, 0x86, 0x34, 0x8d,
+    0x43, 0x16, 0x0f, 0x16, 0x60, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x01, 0x12,
+    0x18, 0x6d, 0x37, 0x44, 0x16, 0x3b, 0x16, 0xeb, 0x01, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0xca, 0xd9, 0x71, 0x44, 0x16, 0x11, 0x16, 0x85,
+    0x03, 0x15, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x0f, 0xa9, 0x1d, 0x44,
+    0xcd, 0x09, 0x13, 0xf6, 0xf3, 0xea, 0x3e, 0xf8, 0x5b, 0xcc, 0xbe, 0x9e,
+    0xc2, 0xa4, 0x3e, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x33, 0x90, 0xe6,
+    0x44, 0x16, 0x37, 0x16, 0x8f, 0x03, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x01,
+    0x12, 0x9b, 0xfe, 0x21, 0x42, 0x16, 0x3f, 0x16, 0x04, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0xc4, 0x8e, 0x9c, 0x44, 0x16, 0x2c, 0x16, 0xe2,
+    0x02, 0x14, 0x70, 0x42, 0x92, 0x95, 0x3e, 0x9a, 0xb0, 0xa8, 0x40, 0x70,
+    0x42, 0x0d, 0x16, 0x00, 0x12, 0x0b, 0xa4, 0xc4, 0x43, 0x16, 0x01, 0x16,
+    0xc8, 0x01, 0x15, 0x70, 0x42, 0x0c, 0x16, 0x01, 0x12, 0xc4, 0x68, 0xf0,
+    0x44, 0x16, 0x2a, 0x16, 0x01, 0x15, 0x70, 0x42, 0x0c, 0x16, 0x02, 0x12,
+    0x32, 0xa5, 0x57, 0x44, 0x16, 0x31, 0x16, 0x2e, 0x15, 0x70, 0x42, 0x0d,
+    0x16, 0x03, 0x12, 0x4a, 0xd9, 0xb5, 0x44, 0x16, 0x1a, 0xb2, 0x3f, 0xbc,
+    0x3f, 0x8e, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0x55, 0xf0, 0x48,
+    0x43, 0x16, 0x36, 0x16, 0x9b, 0x02, 0x15, 0x70, 0x42, 0x0c, 0x16, 0x01,
+    0x12, 0x42, 0xb7, 0xc5, 0x44, 0x16, 0x1f, 0x16, 0x25, 0x14, 0x70, 0x42,
+    0x0d, 0x16, 0x02, 0x12, 0xa0, 0x75, 0x1c, 0x44, 0x16, 0x39, 0x16, 0xe0,
+    0x02, 0x15, 0x70, 0x42, 0x0c, 0x16, 0x03, 0x12, 0x63, 0x1b, 0xbd, 0x44,
+    0x8b, 0xbf, 0x79, 0xab, 0x06, 0x40, 0x70, 0x42, 0x0c, 0x16, 0x00, 0x12,
+    0x6b, 0x1a, 0xcc, 0x44, 0x16, 0x35, 0x16, 0x20, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x01, 0x12, 0xef, 0x3e, 0x74, 0x44, 0x16, 0x24, 0x16, 0x88, 0x03,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x3a, 0xb0, 0xd6, 0x44, 0x16,
+    0x14, 0x16, 0xd6, 0x01, 0x15, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x32,
+    0xfe, 0x8d, 0x44, 0x16, 0x04, 0x13, 0xb6, 0x8d, 0x99, 0x3f, 0x44, 0x6c,
+    0xdc, 0x3e, 0xe2, 0xd1, 0xa7, 0x3f, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12,
+    0xf1, 0x0b, 0x98, 0x44, 0x16, 0x2e, 0x16, 0xfa, 0x02, 0x15, 0x70, 0x42,
+    0x0d, 0x16, 0x01, 0x12, 0xa2, 0x42, 0xa0, 0x44, 0x16, 0x1c, 0x16, 0x92,
+    0x02, 0x15, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x82, 0x60, 0x67, 0x43,
+    0x16, 0x18, 0x16, 0x93, 0x01, 0x14, 0x70, 0x42, 0x3f, 0xea, 0x1c, 0x98,
+    0x3e, 0x1c, 0x7b, 0x98, 0x3f, 0x70, 0x42, 0x0c, 0x16, 0x00, 0x12, 0xe7,
+    0x60, 0xe0, 0x43, 0x16, 0x26, 0x16, 0x27, 0x14, 0x70, 0x42, 0x0c, 0x16,
+    0x01, 0x12, 0x3f, 0x6d, 0x1a, 0x44, 0x16, 0x0c, 0x16, 0x02, 0x14, 0x70,
+    0x42, 0x0c, 0x16, 0x02, 0x12, 0x68, 0x2d, 0xee, 0x44, 0x16, 0x3a, 0x16,
+    0x56, 0x14, 0x70, 0x42, 0x0c, 0x16, 0x03, 0x12, 0x5a, 0x1f, 0x93, 0x44,
+    0xbe, 0x61, 0x7f, 0x1e, 0x40, 0x70, 0x42, 0x0d, 0x16, 0x00, 0x12, 0xc0,
+    0x12, 0xeb, 0x44, 0x16, 0x0f, 0x16, 0xe0, 0x01, 0x14, 0x70, 0x42, 0x0d,
+    0x16, 0x01, 0x12, 0x2b, 0x27, 0x9f, 0x44, 0x16, 0x3d, 0x16, 0xd1, 0x02,
+    0x14, 0x70, 0x42, 0x0d, 0x16, 0x02, 0x12, 0x33, 0x7f, 0x8d, 0x43, 0x16,
+    0x2e, 0x16, 0xfb, 0x02, 0x14, 0x70, 0x42, 0x0d, 0x16, 0x03, 0x12, 0x63,
+    0x9e, 0x90, 0x43, 0x16,
+};
+
+inline std::span<const char> bytes() {
+  return {reinterpret_cast<const char *>(data), sizeof(data)};
+}
+
+} // namespace dictionary
+} // namespace logger
+} // namespace vexmaps
@@ -0,0 +1,374 @@
+/**
+ * @file
+ * @brief Serializes and compresses a frame once and hands the same packet to
+ * any number of sinks, each with its own rate and filter
+ *
+ * Packets are kept in immutable, reference counted SharedFrames. Sinks hold
+ * on to them for as long as they need (a transmit queue until the last byte
+ * went out, a ring until it is overwritten) instead of copying the bytes.
+ * Buffers come back to the fan-out once every sink let go of them, so in
+ * steady state publishing does not allocate.
+ *
+ * Sinks that get every frame share the packets and their sequence numbers.
+ * Packets for a sink that skips frames (decimation or a filter) are wrapped
+ * again with a sequence of its own, so its receiver does not count the
+ * skipped frames as lost. Those sinks cannot be used with streaming
+ * compression (LogSession::setStreaming), since their receivers would be
+ * missing the history of every frame.
+ */
+
+#pragma once
+
+#include "logger.hpp"
+#include "platform.hpp"
+#include "packet.hpp"
+#include "sink.hpp"
+#include "transmitter.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unistd.h>
+#include <vector>
+
+namespace vexmaps {
+namespace logger {
+
+/**
+ * @brief One packet as written by LogSession, never changed once published
+ */
+class SharedFrame {
+private:
+  friend class FanOut;
+  std::vector<char> data;
+  // where the packet starts in data
+  size_t start = 0;
+  // which frame of the fan-out this is, counting from 0
+  uint32_t index = 0;
+  // set by the publisher, e.g. the magic of the message
+  uint32_t tag = 0;
+
+public:
+  std::span<const char> bytes() const {
+    return {data.data() + start, data.size() - start};
+  }
+  uint32_t getIndex() const { return index; }
+  uint32_t getTag() const { return tag; }
+};
+
+using FramePtr = std::shared_ptr<const SharedFrame>;
+
+class FrameSink {
+public:
+  virtual void deliver(const FramePtr &frame) = 0;
+
+  /**
+   * @brief Most frames the sink keeps after deliver() returned, the fan-out
+   * keeps that many buffers for it
+   */
+  virtual size_t heldFrames() const { return 0; }
+
+  virtual ~FrameSink() = default;
+};
+
+/**
+ * @brief Passes frames to a byte Sink, e.g. an FdSink or an Lz4FileSink.
+ * Whether the bytes get copied is up to that sink (FdSink writes large
+ * frames directly)
+ */
+class SinkAdapter : public FrameSink {
+private:
+  Sink &sink;
+  bool flush_every_frame;
+
+public:
+  /**
+   * @param flush_every_frame whether every frame is flushed, true for a
+   * serial FdSink, false for a file sink, which flushes on its own
+   */
+  SinkAdapter(Sink &sink, bool flush_every_frame)
+      : sink(sink), flush_every_frame(flush_every_frame) {}
+
+  void deliver(const FramePtr &frame) override {
+    sink.write(frame->bytes());
+    if (flush_every_frame)
+      sink.flush();
+  }
+
+  ~SinkAdapter() override = default;
+};
+
+/**
+ * @brief Keeps the last few frames in memory, e.g. to dump them after a
+ * crash or send them again on request
+ */
+class FrameRing : public FrameSink {
+private:
+  std::vector<FramePtr> frames;
+  size_t count = 0;
+  size_t next = 0;
+
+public:
+  FrameRing(size_t capacity) : frames(capacity) {
+    assert((capacity > 0) && "a ring needs room for a frame");
+  }
+
+  void deliver(const FramePtr &frame) override {
+    frames[next] = frame;
+    next = (next + 1) % frames.size();
+    count = std::min(count + 1, frames.size());
+  }
+
+  size_t heldFrames() const override { return frames.size(); }
+
+  size_t size() const { return count; }
+
+  /**
+   * @brief i-th frame kept, 0 is the oldest
+   */
+  const FramePtr &get(size_t i) const {
+    return frames[(next + frames.size() - count + i) % frames.size()];
+  }
+
+  ~FrameRing() override = default;
+};
+
+/**
+ * @brief Sends frames a slice at a time like ChunkedTransmitter, but queues
+ * references to the frames instead of copying them. deliver() and pump()
+ * must be called from the same task
+ */
+class FrameTransmitter : public FrameSink {
+private:
+  int fd;
+  // fixed ring of max_frames, so queueing never allocates
+  std::vector<FramePtr> queue;
+  size_t front = 0;
+  size_t count = 0;
+  // bytes of the front frame already sent
+  size_t offset = 0;
+  size_t queued_bytes = 0;
+
+  uint32_t dropped_frames = 0;
+  uint32_t errors = 0;
+
+public:
+  /**
+   * @param max_frames frames that can wait, newer ones are dropped beyond that
+   */
+  FrameTransmitter(int fd = STDOUT_FILENO, size_t max_frames = 4)
+      : fd(fd), queue(max_frames) {
+    assert((max_frames > 0) && "the queue needs room for a frame");
+  }
+
+  bool setNonBlocking() { return platform::setNonBlocking(fd); }
+
+  void deliver(const FramePtr &frame) override {
+    if (count == queue.size()) {
+      dropped_frames++;
+      return;
+    }
+    queue[(front + count++) % queue.size()] = frame;
+    queued_bytes += frame->bytes().size();
+  }
+
+  size_t heldFrames() const override { return queue.size(); }
+
+  /**
+   * @brief Sends until max_bytes were sent, max_micros passed (0 for no
+   * limit), the port is full or the queue is empty
+   *
+   * @return bytes sent
+   */
+  size_t pump(size_t max_bytes, uint32_t max_micros = 0) {
+    bool failed;
+    size_t sent = pump_fd(
+        fd, max_bytes, max_micros,
+        [&]() -> std::span<const char> {
+          if (count == 0)
+            return {};
+          return queue[front]->bytes().subspan(offset);
+        },
+        [&](size_t n) {
+          offset += n;
+          queued_bytes -= n;
+          if (offset == queue[front]->bytes().size()) {
+            // the last reference may be this one, which returns the buffer
+            queue[front].reset();
+            front = (front + 1) % queue.size();
+            count--;
+            offset = 0;
+          }
+        },
+        failed);
+    if (failed)
+      errors++;
+    return sent;
+  }
+
+  size_t backlog() const { return queued_bytes; }
+
+  /**
+   * @brief Frames dropped because the queue was full
+   */
+  uint32_t droppedFrames() const { return dropped_frames; }
+
+  /**
+   * @brief Failed write(2) calls other than a full port
+   */
+  uint32_t writeErrors() const { return errors; }
+
+  ~FrameTransmitter() override = default;
+};
+
+/**
+ * @brief Which frames a sink gets
+ */
+struct SinkPolicy {
+  // every n-th of the frames that pass the filter
+  uint32_t decimation = 1;
+  // nullptr lets every frame through
+  std::function<bool(const SharedFrame &)> filter = nullptr;
+};
+
+/**
+ * @brief Owns the LogSession all frames go through and the sinks they go to
+ */
+class FanOut : private Sink {
+private:
+  struct Output {
+    FrameSink *sink;
+    SinkPolicy policy;
+    uint32_t passed = 0;
+    // sinks that skip frames get their packets wrapped again with this
+    bool own_sequence = false;
+    uint32_t sequence = 0;
+  };
+
+  LogSession session;
+  std::vector<Output> outputs;
+
+  // buffers of earlier frames, reused once no sink holds them anymore. One
+  // for the frame being published plus what every sink can hold
+  std::vector<std::shared_ptr<SharedFrame>> pool{
+      std::make_shared<SharedFrame>()};
+
+  uint32_t frames = 0;
+  uint32_t current_tag = 0;
+  // whether any output has its own sequence
+  bool skipping_sinks = false;
+  size_t largest_frame = 0;
+
+  std::shared_ptr<SharedFrame> takeBuffer() {
+    for (auto &frame : pool)
+      if (frame.use_count() == 1)
+        return frame;
+    // only if a sink holds more frames than its heldFrames()
+    return std::make_shared<SharedFrame>();
+  }
+
+  // a buffer that has to grow grows past the largest frame so far, or every
+  // buffer would grow again each time a frame is a few bytes larger
+  void resize(SharedFrame &frame, size_t size) {
+    largest_frame = std::max(largest_frame, size);
+    if (size > frame.data.capacity())
+      frame.data.reserve(largest_frame + largest_frame / 8);
+    frame.data.resize(size);
+  }
+
+  // same packet with the next sequence number of output
+  FramePtr rewrap(const SharedFrame &shared, Output &output) {
+    uint8_t codec;
+    auto payload = packet::payload(shared.bytes(), codec);
+    auto frame = takeBuffer();
+    resize(*frame, packet::max_header_size + payload.size() +
+                       packet::checksum_size);
+    char *dst = frame->data.data() + packet::max_header_size;
+    std::memcpy(dst, payload.data(), payload.size());
+    size_t packet_size;
+    char *start = packet::wrap(dst, payload.size(), output.sequence++, codec,
+                               packet_size);
+    frame->start = start - frame->data.data();
+    frame->data.resize(frame->start + packet_size);
+    frame->index = shared.index;
+    frame->tag = shared.tag;
+    return frame;
+  }
+
+  // LogSession writes exactly one packet per frame
+  bool write(std::span<const char> data) override {
+    auto frame = takeBuffer();
+    resize(*frame, data.size());
+    std::memcpy(frame->data.data(), data.data(), data.size());
+    frame->start = 0;
+    frame->index = frames++;
+    frame->tag = current_tag;
+
+    FramePtr shared = frame;
+    for (auto &output : outputs) {
+      if (output.policy.filter && !output.policy.filter(*frame))
+        continue;
+      if (output.passed++ % output.policy.decimation != 0)
+        continue;
+      if (output.own_sequence)
+        output.sink->deliver(rewrap(*frame, output));
+      else
+        output.sink->deliver(shared);
+    }
+    return true;
+  }
+
+  bool flush() override { return true; }
+
+public:
+  FanOut() { session.setSink(*this); }
+
+  FanOut(const FanOut &) = delete;
+  FanOut &operator=(const FanOut &) = delete;
+
+  /**
+   * @brief Session used for every frame, to set the codec, streaming or
+   * dictionary. Its sink must stay the fan-out, and sendData() would turn
+   * the stats line into a frame
+   */
+  LogSession &getSession() { return session; }
+
+  /**
+   * @brief Adds a sink, which must stay alive as long as the fan-out. The
+   * buffers for the frames it holds are made now, so publishing does not
+   * allocate them later. A sink that skips frames needs the session to
+   * compress every frame on its own
+   */
+  void addSink(FrameSink &sink, SinkPolicy policy = {}) {
+    policy.decimation = std::max<uint32_t>(policy.decimation, 1);
+    bool own_sequence = policy.decimation > 1 || policy.filter != nullptr;
+    assert((!own_sequence || !session.isStreaming()) &&
+           "a sink that skips frames cannot decode streamed ones");
+    outputs.push_back({&sink, std::move(policy), 0, own_sequence});
+    skipping_sinks |= own_sequence;
+    // plus the one its packet is wrapped in again while being delivered
+    size_t buffers = sink.heldFrames() + (own_sequence ? 1 : 0);
+    for (size_t i = 0; i < buffers; i++)
+      pool.push_back(std::make_shared<SharedFrame>());
+  }
+
+  /**
+   * @brief Serializes and compresses message once and delivers it to every
+   * sink whose policy wants it
+   *
+   * @param tag stored in the frame for the sink filters
+   */
+  template <typename M> SendStats publish(M &message, uint32_t tag = 0) {
+    assert((!session.isStreaming() || !skipping_sinks) &&
+           "a sink that skips frames cannot decode streamed ones");
+    current_tag = tag;
+    return session.send(message);
+  }
+
+  uint32_t publishedFrames() const { return frames; }
+};
+
+} // namespace logger
+} // namespace vexmaps
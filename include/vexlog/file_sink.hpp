@@ -0,0 +1,167 @@
+/**
+ * @file
+ * @brief Sink that records to a file as an LZ4 frame, for full matches on the
+ * SD card (/usd/... on the brain) or a plain file on the host
+ *
+ * The file is a standard LZ4 frame with linked 64KB blocks and block
+ * checksums, so `lz4 -d` turns it back into the byte stream the sink was
+ * given. Blocks only reference the previous 64KB, so memory stays bounded:
+ * the LZ4F context plus one compressed block buffer.
+ *
+ * Every flush_bytes of input the block is closed with LZ4F_flush and handed
+ * to the file system, so losing power only loses what came in since then.
+ * Files cut short that way still decompress up to the last flushed block.
+ * flush() does nothing until then, so LogSession flushing after every frame
+ * neither shrinks the blocks nor keeps the SD card busy. sync() forces a
+ * flush, e.g. at the end of a match.
+ *
+ * To record every generation use it as the sink of a LogSession with a
+ * NoneCodec: the raw frames compress much better here, where the blocks are
+ * linked, than frame by frame.
+ */
+
+#pragma once
+
+#include "lz4/lz4frame.h"
+#include "sink.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <span>
+
+namespace vexmaps {
+namespace logger {
+
+class Lz4FileSink : public Sink {
+public:
+  static constexpr size_t block_size = 64 * 1024;
+
+private:
+  FILE *file = nullptr;
+  LZ4F_cctx *context = nullptr;
+  LZ4F_preferences_t preferences = LZ4F_INIT_PREFERENCES;
+
+  // one block of compressed output, or the frame header / end mark
+  std::unique_ptr<char[]> out;
+  size_t out_capacity = 0;
+
+  size_t flush_bytes;
+  size_t unflushed = 0;
+
+  uint32_t errors = 0;
+
+  bool emit(size_t result) {
+    if (LZ4F_isError(result)) {
+      errors++;
+      return false;
+    }
+    if (result > 0 && std::fwrite(out.get(), 1, result, file) != result) {
+      errors++;
+      return false;
+    }
+    return true;
+  }
+
+public:
+  /**
+   * @param path file to create, replaced if it exists
+   * @param flush_bytes input between flushes, at most what a brownout loses
+   */
+  Lz4FileSink(const char *path, size_t flush_bytes = block_size)
+      : flush_bytes(flush_bytes) {
+    file = std::fopen(path, "wb");
+    if (file == nullptr ||
+        LZ4F_isError(LZ4F_createCompressionContext(&context, LZ4F_VERSION))) {
+      errors++;
+      return;
+    }
+
+    preferences.frameInfo.blockSizeID = LZ4F_max64KB;
+    preferences.frameInfo.blockMode = LZ4F_blockLinked;
+    // corrupt blocks on the card get caught instead of decoding to garbage
+    preferences.frameInfo.blockChecksumFlag = LZ4F_blockChecksumEnabled;
+
+    out_capacity = std::max<size_t>(
+        LZ4F_compressBound(block_size, &preferences), LZ4F_HEADER_SIZE_MAX);
+    out = std::make_unique<char[]>(out_capacity);
+    emit(LZ4F_compressBegin(context, out.get(), out_capacity, &preferences));
+  }
+
+  Lz4FileSink(const Lz4FileSink &) = delete;
+  Lz4FileSink &operator=(const Lz4FileSink &) = delete;
+
+  bool isOpen() const { return file != nullptr && context != nullptr; }
+
+  bool write(std::span<const char> data) override {
+    if (!isOpen())
+      return false;
+    // pieces of at most a block keep the output within out_capacity
+    while (!data.empty()) {
+      size_t len = std::min(data.size(), block_size);
+      if (!emit(LZ4F_compressUpdate(context, out.get(), out_capacity,
+                                    data.data(), len, nullptr)))
+        return false;
+      data = data.subspan(len);
+      unflushed += len;
+      if (unflushed >= flush_bytes && !sync())
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Only syncs once flush_bytes came in since the last sync
+   */
+  bool flush() override {
+    if (unflushed < flush_bytes)
+      return isOpen();
+    return sync();
+  }
+
+  /**
+   * @brief Ends the current block and hands everything to the file system
+   */
+  bool sync() {
+    if (!isOpen())
+      return false;
+    unflushed = 0;
+    if (!emit(LZ4F_flush(context, out.get(), out_capacity, nullptr)))
+      return false;
+    if (std::fflush(file) != 0) {
+      errors++;
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Writes the end mark and closes the file, later writes fail
+   */
+  bool close() {
+    if (!isOpen())
+      return false;
+    bool ok =
+        emit(LZ4F_compressEnd(context, out.get(), out_capacity, nullptr));
+    ok &= std::fclose(file) == 0;
+    file = nullptr;
+    LZ4F_freeCompressionContext(context);
+    context = nullptr;
+    return ok;
+  }
+
+  /**
+   * @brief Failed compressions or file writes
+   */
+  uint32_t writeErrors() const { return errors; }
+
+  ~Lz4FileSink() override {
+    close();
+    if (file != nullptr)
+      std::fclose(file);
+    if (context != nullptr)
+      LZ4F_freeCompressionContext(context);
+  }
+};
+
+} // namespace logger
+} // namespace vexmaps
@@ -1,22 +1,75 @@
 #pragma once
-#include <arm_neon.h>
+#include "simd.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace vexmaps {
 namespace logger {
 /**
- * @brief transforms floats within the range [a,b] into a list of
- * differences of unsigned within the range [0,2^13 / mod]
+ * @brief finds the smallest and largest value of K arrays in a single sweep,
+ * so each array is only read once
+ *
+ * @param data K arrays of len elements, len must be at least 1
+ * @param bounds where the (min, max) of every array gets stored
+ */
+template <size_t K>
+inline void float_bounds(const float *const (&data)[K], size_t len,
+                         std::pair<float, float> (&bounds)[K]) {
+  simd::f32x4 lows[K];
+  simd::f32x4 highs[K];
+  for (int k = 0; k < K; k++)
+    lows[k] = highs[k] = simd::dup(data[k][0]);
+
+  const size_t remaining_floats = len - (len % 8);
+
+  for (int i = 0; i < remaining_floats; i += 8) {
+    for (int k = 0; k < K; k++) {
+      simd::f32x4 v1 = simd::load(&data[k][i]);
+      simd::f32x4 v2 = simd::load(&data[k][i + 4]);
+      lows[k] = simd::min(lows[k], simd::min(v1, v2));
+      highs[k] = simd::max(highs[k], simd::max(v1, v2));
+    }
+  }
+
+  for (int k = 0; k < K; k++) {
+    bounds[k] = {simd::hmin(lows[k]), simd::hmax(highs[k])};
+    for (int i = remaining_floats; i < len; i++) {
+      bounds[k].first = std::min(data[k][i], bounds[k].first);
+      bounds[k].second = std::max(data[k][i], bounds[k].second);
+    }
+  }
+}
+
+/**
+ * @brief smallest and largest value of data, len must be at least 1
+ */
+inline std::pair<float, float> float_bounds(const float *data, size_t len) {
+  std::pair<float, float> bounds[1];
+  float_bounds({data}, len, bounds);
+  return bounds[0];
+}
+
+/**
+ * @brief nearest integer, halfway cases away from zero like simd::round_s32
+ */
+inline int32_t round_nearest(float v) {
+  return static_cast<int32_t>(v + std::copysign(0.5f, v));
+}
+
+/**
+ * @brief quantizes floats into (x - a) * scale, rounded to the nearest integer
  *
  * @param data float data
  * @param result where the results get stored
  * @param len number of elements
  */
-inline uint32_t compress_floats(float *data, int16_t *result, size_t len,
-                                float a, float b, int mod = (1 << 13)) {
-  //  a/2^15
-  const float c0 = static_cast<float>(mod) / (b - a);
+inline void quantize_floats(const float *data, int16_t *result, size_t len,
+                            float a, float scale) {
+  const float c0 = scale;
   // r = (x - a) * c0
   // r = x * c0 - a * c0
   // r = (-a * c0) + x * c0
@@ -25,55 +78,205 @@ inline uint32_t compress_floats(float *data, int16_t *result, size_t len,
 
   const size_t remaining_floats = len - (len % 16);
 
-  float32x4_t vc0 = vdupq_n_f32(c0);
-  float32x4_t vc1 = vdupq_n_f32(c1);
+  simd::f32x4 vc0 = simd::dup(c0);
+  simd::f32x4 vc1 = simd::dup(c1);
 
   for (int i = 0; i < remaining_floats; i += 16) {
-    float32x4_t v1 = vld1q_f32(&data[i]);
-    float32x4_t v2 = vld1q_f32(&data[i + 4]);
-    float32x4_t v3 = vld1q_f32(&data[i + 8]);
-    float32x4_t v4 = vld1q_f32(&data[i + 12]);
-
-    v1 = vmlaq_f32(vc1, v1, vc0);
-    v2 = vmlaq_f32(vc1, v2, vc0);
-    v3 = vmlaq_f32(vc1, v3, vc0);
-    v4 = vmlaq_f32(vc1, v4, vc0);
-
-    int32x4_t converted1 = vcvtq_s32_f32(v1);
-    int32x4_t converted2 = vcvtq_s32_f32(v2);
-    int32x4_t converted3 = vcvtq_s32_f32(v3);
-    int32x4_t converted4 = vcvtq_s32_f32(v4);
-
-    int16x4_t final1 = vmovn_s32(converted1);
-    int16x4_t final2 = vmovn_s32(converted2);
-    int16x4_t final3 = vmovn_s32(converted3);
-    int16x4_t final4 = vmovn_s32(converted4);
-    // store results
-    vst1_s16(result + i, final1);
-    vst1_s16(result + i + 4, final2);
-    vst1_s16(result + i + 8, final3);
-    vst1_s16(result + i + 12, final4);
+    simd::f32x4 v1 = simd::load(&data[i]);
+    simd::f32x4 v2 = simd::load(&data[i + 4]);
+    simd::f32x4 v3 = simd::load(&data[i + 8]);
+    simd::f32x4 v4 = simd::load(&data[i + 12]);
+
+    v1 = simd::mla(vc1, v1, vc0);
+    v2 = simd::mla(vc1, v2, vc0);
+    v3 = simd::mla(vc1, v3, vc0);
+    v4 = simd::mla(vc1, v4, vc0);
+
+    simd::s32x4 converted1 = simd::round_s32(v1);
+    simd::s32x4 converted2 = simd::round_s32(v2);
+    simd::s32x4 converted3 = simd::round_s32(v3);
+    simd::s32x4 converted4 = simd::round_s32(v4);
+
+    // narrow and store results
+    simd::store_narrow_s16(result + i, converted1);
+    simd::store_narrow_s16(result + i + 4, converted2);
+    simd::store_narrow_s16(result + i + 8, converted3);
+    simd::store_narrow_s16(result + i + 12, converted4);
   }
   // go through remaining particles if neccesary
   for (int i = remaining_floats; i < len; i++) {
-    result[i] = static_cast<int16_t>(c1 + data[i] * c0);
+    // same rounding as the vector path, no fused multiply-add
+    float scaled = data[i] * c0;
+    result[i] = static_cast<int16_t>(round_nearest(c1 + scaled));
   }
+}
+
+/**
+ * @brief transforms floats within the range [a,b] into a list of
+ * differences of the nearest of the mod + 1 evenly spaced values from a to b,
+ * so the error is at most (b - a) / mod / 2
+ *
+ * @param data float data
+ * @param result where the results get stored
+ * @param len number of elements
+ * @param mod at most 32767, so every value and difference fits in an int16
+ */
+inline uint32_t compress_floats(float *data, int16_t *result, size_t len,
+                                float a, float b, int mod = (1 << 13)) {
+  // every value is a when there is no range
+  const float c0 = b > a ? static_cast<float>(mod) / (b - a) : 0;
+  // same as quantize_floats
+  const float c1 = (-a) * c0;
 
   // we assume particles will be vaguely near each other, so we can try and use
-  // delta encoding to reduce their sizes
+  // delta encoding to reduce their sizes. Quantizing and differencing in the
+  // same pass means the data only gets read once
+
+  const size_t remaining_floats = len - (len % 16);
+
+  simd::f32x4 vc0 = simd::dup(c0);
+  simd::f32x4 vc1 = simd::dup(c1);
+  // float error can put values just outside the range
+  simd::f32x4 vlow = simd::dup(0);
+  simd::f32x4 vhigh = simd::dup(static_cast<float>(mod));
+  auto quantize = [&](const float *p) {
+    simd::f32x4 v = simd::mla(vc1, simd::load(p), vc0);
+    return simd::round_s32(simd::min(simd::max(v, vlow), vhigh));
+  };
+
+  // first element left alone, it is compared against 0
+  simd::s16x8 last = simd::zero_s16();
+
+  for (int i = 0; i < remaining_floats; i += 16) {
+    simd::s16x8 curr1 =
+        simd::narrow_s16(quantize(&data[i]), quantize(&data[i + 4]));
+    simd::s16x8 curr2 =
+        simd::narrow_s16(quantize(&data[i + 8]), quantize(&data[i + 12]));
 
-  // first element left alone
-  int16_t last = result[0];
+    // every lane minus the lane before it, which may be in the previous vector
+    simd::store_s16(result + i,
+                    simd::sub(curr1, simd::prev_lanes(last, curr1)));
+    simd::store_s16(result + i + 8,
+                    simd::sub(curr2, simd::prev_lanes(curr1, curr2)));
+    last = curr2;
+  }
+
+  int16_t last_scalar = 0;
+  if (remaining_floats > 0) {
+    int16_t tmp[8];
+    simd::store_s16(tmp, last);
+    last_scalar = tmp[7];
+  }
 
-  // TODO: could vectorize if an intermediate array was used
-  for (int i = 1; i < len; i++) {
-    int16_t curr = result[i];
+  // go through remaining particles if neccesary
+  for (int i = remaining_floats; i < len; i++) {
+    // same rounding as the vector path, no fused multiply-add
+    float scaled = data[i] * c0;
+    float clamped = std::min(std::max(c1 + scaled, 0.0f),
+                             static_cast<float>(mod));
+    int16_t curr = static_cast<int16_t>(round_nearest(clamped));
     // differences can be negative
-    result[i] = curr - last;
-    last = curr;
+    result[i] = curr - last_scalar;
+    last_scalar = curr;
   }
 
   return mod;
 }
+
+/**
+ * @brief smallest mod for which compress_floats over [a,b] stays within
+ * max_error of every value, capped at 32767 (which may not be enough for a
+ * huge range)
+ */
+inline uint32_t error_bounded_mod(float a, float b, float max_error) {
+  constexpr uint32_t max_mod = 32767;
+  if (!(b > a))
+    return 1;
+  if (!(max_error > 0))
+    return max_mod;
+  // rounding gives half a step of error, the rest of the bound has to cover
+  // the float error of quantizing and decoding, a few ulps of the values
+  double magnitude = std::max(std::abs(a), std::abs(b));
+  double budget = max_error - 4 * magnitude * FLT_EPSILON;
+  if (budget <= 0)
+    return max_mod;
+  double steps = std::ceil((static_cast<double>(b) - a) / (2 * budget));
+  return static_cast<uint32_t>(std::clamp(steps, 1.0, double(max_mod)));
+}
+
+/**
+ * @brief inverse of compress_floats, the result is the nearest of the mod + 1
+ * values compress_floats picks from
+ *
+ * @param data differences written by compress_floats
+ * @param result where the floats get stored
+ * @param len number of elements
+ */
+inline void decompress_floats(const int16_t *data, float *result, size_t len,
+                              float a, float b, int mod = (1 << 13)) {
+  const float step = (b - a) / static_cast<float>(mod);
+
+  const size_t remaining_floats = len - (len % 8);
+
+  simd::f32x4 va = simd::dup(a);
+  simd::f32x4 vstep = simd::dup(step);
+
+  // running sum of everything before the current vector, in every lane
+  simd::s16x8 carry = simd::zero_s16();
+
+  for (int i = 0; i < remaining_floats; i += 8) {
+    // prefix sum within the vector in log2(8) steps
+    simd::s16x8 v = simd::load_s16(data + i);
+    v = simd::add(v, simd::shift_lanes<1>(v));
+    v = simd::add(v, simd::shift_lanes<2>(v));
+    v = simd::add(v, simd::shift_lanes<4>(v));
+    v = simd::add(v, carry);
+    carry = simd::dup_last(v);
+
+    simd::store(&result[i],
+                simd::mla(va, simd::cvt_f32(simd::widen_lo(v)), vstep));
+    simd::store(&result[i + 4],
+                simd::mla(va, simd::cvt_f32(simd::widen_hi(v)), vstep));
+  }
+
+  int16_t sum = 0;
+  if (remaining_floats > 0) {
+    int16_t tmp[8];
+    simd::store_s16(tmp, carry);
+    sum = tmp[0];
+  }
+
+  for (int i = remaining_floats; i < len; i++) {
+    sum = static_cast<int16_t>(sum + data[i]);
+    float scaled = static_cast<float>(sum) * step;
+    result[i] = a + scaled;
+  }
+}
+
+struct QuantizationError {
+  float max;
+  float rms;
+};
+
+/**
+ * @brief decodes what compress_floats wrote and compares it to the original
+ * data, for checking error bounds on the host. Allocates a temporary buffer
+ */
+inline QuantizationError quantization_error(const float *data,
+                                            const int16_t *compressed,
+                                            size_t len, float a, float b,
+                                            int mod) {
+  std::vector<float> decoded(len);
+  decompress_floats(compressed, decoded.data(), len, a, b, mod);
+  double max = 0;
+  double sum = 0;
+  for (size_t i = 0; i < len; i++) {
+    double error = std::abs(static_cast<double>(decoded[i]) - data[i]);
+    max = std::max(max, error);
+    sum += error * error;
+  }
+  return {static_cast<float>(max),
+          len > 0 ? static_cast<float>(std::sqrt(sum / len)) : 0.0f};
+}
 } // namespace logger
 } // namespace vexmaps
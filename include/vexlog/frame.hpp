@@ -0,0 +1,270 @@
+/**
+ * @file
+ * @brief Frame format produced by LogSession, and a decoder for it
+ *
+ * Every compressed message is sent as a frame:
+ *
+ * [flags][dictionary id, only with flag_dictionary](raw size)[lz4 block]
+ *
+ * where raw size is the varint size of the message before compression.
+ * Frames with flag_stream set were compressed with the history of the frames
+ * before them, so they can only be decoded by a receiver that has seen every
+ * frame since the last one with flag_reset.
+ *
+ * flag_dictionary means the history started with a preset dictionary, the
+ * 4 byte little endian id tells the receiver which one. Streamed frames only
+ * carry it on reset frames.
+ *
+ * The upper 4 bits of the flags are the codec of the block. codec_none blocks
+ * are the raw message, they still become part of the history of streamed
+ * frames.
+ */
+
+#pragma once
+
+#include "lz4/lz4.h"
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace vexmaps {
+namespace logger {
+namespace frame {
+
+// compressed with the history of the previous frames
+constexpr uint8_t flag_stream = 1 << 0;
+// first frame after the history was cleared, receivers can sync here
+constexpr uint8_t flag_reset = 1 << 1;
+// compressed with a preset dictionary, its id follows the flags
+constexpr uint8_t flag_dictionary = 1 << 2;
+
+// codec ids, stored in the upper bits of the flags
+constexpr uint8_t codec_none = 0;
+constexpr uint8_t codec_lz4 = 1;
+// same block format as codec_lz4
+constexpr uint8_t codec_lz4hc = 2;
+constexpr int codec_shift = 4;
+
+inline uint8_t codec(uint8_t flags) { return flags >> codec_shift; }
+
+// history kept by LZ4 between frames
+constexpr size_t max_history = 64 * 1024;
+
+// flags byte, dictionary id and a 32 bit varint
+constexpr size_t max_header_size = 1 + 4 + 5;
+
+// largest message LogSession sends, receivers take larger frames as corrupt
+constexpr size_t max_raw_size = 128 * 1024;
+
+/**
+ * @brief Largest frame a message of raw_size bytes can become, with any codec
+ */
+constexpr size_t bound(size_t raw_size) {
+  return max_header_size + LZ4_COMPRESSBOUND(raw_size);
+}
+
+} // namespace frame
+
+/**
+ * @brief Turns frames back into serialized messages.
+ *
+ * A decoder that starts in the middle of a stream skips streamed frames
+ * until the next reset point.
+ */
+class FrameDecoder {
+private:
+  LZ4_streamDecode_t stream;
+  // decoded frames, the last frame::max_history bytes are the LZ4 history
+  std::vector<char> history;
+  size_t history_offset = 0;
+  bool synced = false;
+
+  std::vector<char> independent;
+
+  struct Dictionary {
+    uint32_t id;
+    std::span<const char> data;
+  };
+  std::vector<Dictionary> dictionaries;
+
+  uint32_t skipped_frames = 0;
+  uint32_t unknown_dictionary_frames = 0;
+  uint32_t unknown_codec_frames = 0;
+
+  const Dictionary *findDictionary(uint32_t id) const {
+    for (const auto &dictionary : dictionaries)
+      if (dictionary.id == id)
+        return &dictionary;
+    return nullptr;
+  }
+
+  // makes room for len more bytes while keeping the history
+  char *historySpace(size_t len) {
+    if (history_offset + len > history.size()) {
+      size_t keep = std::min(history_offset, frame::max_history);
+      if (keep + len > history.size())
+        history.resize(std::max(2 * history.size(), keep + len));
+      std::memmove(history.data(), history.data() + history_offset - keep,
+                   keep);
+      LZ4_setStreamDecode(&stream, history.data(), keep);
+      history_offset = keep;
+    }
+    return history.data() + history_offset;
+  }
+
+  static bool readVarint(std::span<const char> data, size_t &i,
+                         uint32_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && i < data.size(); shift += 7) {
+      uint8_t byte = data[i++];
+      value |= static_cast<uint32_t>(byte & 127) << shift;
+      if (!(byte & 128))
+        return true;
+    }
+    return false;
+  }
+
+public:
+  FrameDecoder() : history(2 * frame::max_history) {}
+
+  /**
+   * @brief Makes a dictionary available to frames that ask for its id, it
+   * must stay alive as long as the decoder
+   */
+  void addDictionary(std::span<const char> data, uint32_t id) {
+    dictionaries.push_back({id, data});
+  }
+
+  /**
+   * @brief Decodes one frame, returns the serialized message or an empty span
+   * if the frame could not be decoded (corrupt, or no reset point seen yet).
+   *
+   * The result is only valid until the next call
+   */
+  std::span<const char> decode(std::span<const char> data) {
+    if (data.empty())
+      return {};
+
+    uint8_t flags = data[0];
+    size_t i = 1;
+
+    const Dictionary *dictionary = nullptr;
+    if (flags & frame::flag_dictionary) {
+      if (data.size() < i + 4)
+        return {};
+      uint32_t id;
+      std::memcpy(&id, data.data() + i, 4);
+      i += 4;
+      dictionary = findDictionary(id);
+      if (dictionary == nullptr) {
+        // decoding with the wrong dictionary would only produce garbage
+        unknown_dictionary_frames++;
+        if (flags & frame::flag_stream)
+          synced = false;
+        return {};
+      }
+    }
+
+    uint32_t raw_size;
+    if (!readVarint(data, i, raw_size))
+      return {};
+
+    const char *src = data.data() + i;
+    int src_size = data.size() - i;
+
+    const uint8_t codec = frame::codec(flags);
+    if (codec != frame::codec_none && codec != frame::codec_lz4 &&
+        codec != frame::codec_lz4hc) {
+      unknown_codec_frames++;
+      if (flags & frame::flag_stream)
+        synced = false;
+      return {};
+    }
+
+    if (!(flags & frame::flag_stream)) {
+      if (codec == frame::codec_none) {
+        if (src_size != static_cast<int>(raw_size))
+          return {};
+        return {src, raw_size};
+      }
+      if (independent.size() < raw_size)
+        independent.resize(raw_size);
+      int n = dictionary == nullptr
+                  ? LZ4_decompress_safe(src, independent.data(), src_size,
+                                        raw_size)
+                  : LZ4_decompress_safe_usingDict(
+                        src, independent.data(), src_size, raw_size,
+                        dictionary->data.data(), dictionary->data.size());
+      if (n != static_cast<int>(raw_size))
+        return {};
+      return {independent.data(), raw_size};
+    }
+
+    if (flags & frame::flag_reset) {
+      history_offset = 0;
+      if (dictionary != nullptr) {
+        // same layout as the encoder, the dictionary is the start of the
+        // history
+        std::memcpy(history.data(), dictionary->data.data(),
+                    dictionary->data.size());
+        history_offset = dictionary->data.size();
+      }
+      LZ4_setStreamDecode(&stream, history.data(), history_offset);
+      synced = true;
+    } else if (!synced) {
+      skipped_frames++;
+      return {};
+    }
+
+    char *dst = historySpace(raw_size);
+    int n;
+    if (codec == frame::codec_none) {
+      n = src_size == static_cast<int>(raw_size) ? src_size : -1;
+      if (n >= 0) {
+        std::memcpy(dst, src, raw_size);
+        // LZ4 did not see these bytes go by, point it at the whole history
+        LZ4_setStreamDecode(&stream, history.data(),
+                            history_offset + raw_size);
+      }
+    } else {
+      n = LZ4_decompress_safe_continue(&stream, src, dst, src_size, raw_size);
+    }
+    if (n != static_cast<int>(raw_size)) {
+      // history is unusable until the next reset
+      synced = false;
+      skipped_frames++;
+      return {};
+    }
+    history_offset += raw_size;
+    return {dst, raw_size};
+  }
+
+  /**
+   * @brief Tells the decoder a frame went missing (see PacketDecoder), so it
+   * does not decode streamed frames against the wrong history
+   */
+  void frameLost() { synced = false; }
+
+  bool isSynced() const { return synced; }
+
+  /**
+   * @brief Streamed frames that could not be decoded
+   */
+  uint32_t skippedFrames() const { return skipped_frames; }
+
+  /**
+   * @brief Frames that asked for a dictionary that was never added
+   */
+  uint32_t unknownDictionaryFrames() const {
+    return unknown_dictionary_frames;
+  }
+
+  /**
+   * @brief Frames compressed with a codec this decoder does not know
+   */
+  uint32_t unknownCodecFrames() const { return unknown_codec_frames; }
+};
+
+} // namespace logger
+} // namespace vexmaps
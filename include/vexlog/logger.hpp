@@ -5,14 +5,20 @@
 
 #pragma once
 
-#include "pros/apix.h"
-#include <arm_neon.h>
+#include "platform.hpp"
 #include <cassert>
+#include <cstdio>
 #include <cstring>
+#include <iostream>
+#include <memory>
+#include <span>
 #include <type_traits>
 #include <vector>
 
-#include "lz4/lz4.h"
+#include "codec.hpp"
+#include "frame.hpp"
+#include "packet.hpp"
+#include "sink.hpp"
 
 namespace vexmaps {
 namespace logger {
@@ -26,78 +32,279 @@ namespace logger {
 // [children magic1][children magic2](size in bytes)[child1][child2]...
 // ...
 
-// vectors might still be slow
-// TODO: add error checking
+/**
+ * @brief Growable output buffer backed by a list of chunks.
+ *
+ * Growing never copies bytes that were already written, a new chunk is simply
+ * appended. Every write checks the space left in the current chunk. Callers
+ * that know an upper bound for what they are about to write can call
+ * reserve() once and then use the put functions, which skip the check.
+ *
+ * When clear() is called after the bytes of a frame ended up in several
+ * chunks they get merged into a single larger chunk, so a reused buffer
+ * quickly settles on one contiguous chunk.
+ */
 class LogBuffer {
 private:
-  std::vector<char> buf;
-  // index must always be the size of the vector!
-  size_t ind = 0;
-  void setIndex(size_t i) { ind = i; }
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    size_t capacity;
+    // bytes used, only up to date for chunks before the current one
+    size_t len = 0;
+  };
+
+  std::vector<Chunk> chunks;
+  size_t chunk_size;
+  size_t current = 0;
+  // bytes stored in the chunks before the current one
+  size_t prefix_len = 0;
+
+  char *cur = nullptr;
+  char *end = nullptr;
+
+  // moves on to a chunk with at least len bytes of room
+  void grow(size_t len) {
+    if (!chunks.empty()) {
+      chunks[current].len = cur - chunks[current].data.get();
+      prefix_len += chunks[current].len;
+      current++;
+    }
+
+    size_t capacity = std::max(chunk_size, len);
+    if (current == chunks.size()) {
+      chunks.push_back({std::make_unique<char[]>(capacity), capacity});
+    } else if (chunks[current].capacity < len) {
+      chunks[current] = {std::make_unique<char[]>(capacity), capacity};
+    }
+
+    cur = chunks[current].data.get();
+    end = cur + chunks[current].capacity;
+  }
+
+  // checked after the put rather than before, a check of the worst case
+  // ahead of the varint array loops halves their speed. Running past what
+  // was reserved means a maxSize() is too small
+  void assertReserved() const {
+    assert(cur <= end && "put without a reserve() covering it");
+  }
 
 public:
-  LogBuffer(size_t len) : buf(len) {}
+  static constexpr size_t default_chunk_size = 16 * 1024;
+
+  LogBuffer(size_t chunk_size = default_chunk_size) : chunk_size(chunk_size) {}
+
+  /**
+   * @brief Makes sure the next len bytes are contiguous and allocated
+   */
+  inline void reserve(size_t len) {
+    if (static_cast<size_t>(end - cur) < len) [[unlikely]]
+      grow(len);
+  }
+
+  /**
+   * @brief Returns len contiguous writable bytes for kernels that encode
+   * straight into the buffer. Call commit() with how many were actually used
+   */
+  char *claim(size_t len) {
+    reserve(len);
+    return cur;
+  }
 
-  std::vector<char> &getVector() { return buf; }
+  void commit(size_t len) { cur += len; }
+
+  /**
+   * @brief Rewinds the buffer so it can be reused without allocating
+   */
+  void clear() {
+    if (current > 0) {
+      // merge everything into one chunk so the next frame is contiguous
+      size_t capacity = 0;
+      for (auto &chunk : chunks)
+        capacity += chunk.capacity;
+      chunks.clear();
+      chunks.push_back({std::make_unique<char[]>(capacity), capacity});
+    }
+    current = 0;
+    prefix_len = 0;
+    if (chunks.empty()) {
+      cur = end = nullptr;
+    } else {
+      cur = chunks[0].data.get();
+      end = cur + chunks[0].capacity;
+    }
+  }
+
+  size_t size() const {
+    if (chunks.empty())
+      return 0;
+    return prefix_len + (cur - chunks[current].data.get());
+  }
+
+  size_t chunkCount() const { return chunks.empty() ? 0 : current + 1; }
+
+  /**
+   * @brief Returns the written part of chunk i
+   */
+  std::span<const char> chunk(size_t i) const {
+    size_t len = i == current ? cur - chunks[i].data.get() : chunks[i].len;
+    return {chunks[i].data.get(), len};
+  }
 
   inline void writeByte(char data) {
-    buf[ind] = data;
-    ind++;
+    reserve(1);
+    *cur++ = data;
+  }
+
+  /**
+   * @brief Same as write_bytes, without the capacity check. Like every put
+   * function it must be covered by an earlier reserve()
+   */
+  size_t put_bytes(std::span<const char> data) {
+    std::memcpy(cur, data.data(), data.size());
+    cur += data.size();
+    assertReserved();
+    return data.size();
+  }
+
+  template <typename T> size_t put(T data) {
+    std::memcpy(cur, &data, sizeof(data));
+    cur += sizeof(data);
+    assertReserved();
+    return sizeof(data);
+  }
+
+  template <typename T>
+    requires std::is_unsigned_v<T>
+  size_t put_varint(T data) {
+    char *start = cur;
+    cur = encode_varint(cur, data);
+    assertReserved();
+    return cur - start;
+  }
+
+  template <typename T>
+    requires std::is_signed_v<T>
+  size_t put_varint(T data) {
+    return put_varint(zigzag(data));
   }
 
-  void advanceIndex(size_t offset = 1) { ind += offset; }
+  size_t put_varint_array(const int16_t *data, size_t n) {
+    char *start = cur;
+    char *p = cur;
+    for (size_t i = 0; i < n; i++)
+      p = encode_varint(p, zigzag(data[i]));
+    cur = p;
+    assertReserved();
+    return cur - start;
+  }
+
+  size_t put_varint_array(const uint32_t *data, size_t n) {
+    char *start = cur;
+    char *p = cur;
+    for (size_t i = 0; i < n; i++)
+      p = encode_varint(p, data[i]);
+    cur = p;
+    assertReserved();
+    return cur - start;
+  }
 
-  size_t getIndex() { return ind; }
+  size_t getIndex() const { return size(); }
 
   size_t write(char *data, int len) {
-    for (int i = 0; i < len; i++)
-      writeByte(data[i]);
-    return len;
+    return write_bytes({data, static_cast<size_t>(len)});
+  }
+
+  size_t write_bytes(std::span<const char> data) {
+    reserve(data.size());
+    return put_bytes(data);
   }
 
   template <typename T> size_t write(T data) {
-    char *char_data = reinterpret_cast<char *>(&data);
-    for (int i = 0; i < sizeof(data); i++) {
-      writeByte(char_data[i]);
-    }
-    return sizeof(data);
+    reserve(sizeof(data));
+    return put(data);
   }
 
   // code modified from https://github.com/tidwall/varint.c
   template <typename T>
     requires std::is_unsigned_v<T>
   size_t write_varint(T data) {
-    if (data < 128) {
-      writeByte(data);
-      return 1;
-    }
-    int n = 0;
-    do {
-      writeByte((uint8_t)data | 128);
-      n++;
+    reserve(max_varint_size<T>());
+    return put_varint(data);
+  }
+
+  template <typename T>
+    requires std::is_signed_v<T>
+  size_t write_varint(T data) {
+    return write_varint(zigzag(data));
+  }
+
+  /**
+   * @brief Writes n varints with a single capacity check
+   */
+  size_t write_varint_array(const int16_t *data, size_t n) {
+    reserve(n * max_varint_size<uint16_t>());
+    return put_varint_array(data, n);
+  }
+
+  size_t write_varint_array(const uint32_t *data, size_t n) {
+    reserve(n * max_varint_size<uint32_t>());
+    return put_varint_array(data, n);
+  }
+
+  template <typename T> static constexpr size_t max_varint_size() {
+    return (sizeof(T) * 8 + 6) / 7;
+  }
+
+  template <typename T>
+    requires std::is_unsigned_v<T>
+  static constexpr size_t varint_size(T data) {
+    size_t n = 1;
+    while (data >= 128) {
       data >>= 7;
-    } while (data >= 128);
-    writeByte((uint8_t)data);
-    n++;
+      n++;
+    }
     return n;
   }
 
   template <typename T>
     requires std::is_signed_v<T>
-  size_t write_varint(T data) {
-    uint64_t ux = (uint64_t)data << 1;
-    ux = data < 0 ? ~ux : ux;
-    return write_varint(ux);
+  static constexpr size_t varint_size(T data) {
+    return varint_size(zigzag(data));
   }
 
   /**
-   * @brief Writes data at specific index
+   * @brief Size write_varint_array would write for the same data
    */
-  template <typename... Args> void write_index(int i, Args... args) {
-    size_t currentIndex = getIndex();
-    setIndex(i);
-    write(args...);
-    setIndex(currentIndex);
+  static size_t varint_array_size(const int16_t *data, size_t n) {
+    size_t len = n;
+    for (size_t i = 0; i < n; i++) {
+      uint16_t v = zigzag(data[i]);
+      len += (v >= (1 << 7)) + (v >= (1 << 14));
+    }
+    return len;
+  }
+
+  template <typename T>
+    requires std::is_signed_v<T>
+  static constexpr std::make_unsigned_t<T> zigzag(T data) {
+    using U = std::make_unsigned_t<T>;
+    U ux = static_cast<U>(data) << 1;
+    return data < 0 ? ~ux : ux;
+  }
+
+  /**
+   * @brief Encodes a single varint at p, returns the end of what was written.
+   * p must have room for max_varint_size<T>() bytes
+   */
+  template <typename T>
+    requires std::is_unsigned_v<T>
+  static inline char *encode_varint(char *p, T data) {
+    while (data >= 128) {
+      *p++ = static_cast<char>(static_cast<uint8_t>(data) | 128);
+      data >>= 7;
+    }
+    *p++ = static_cast<char>(data);
+    return p;
   }
 };
 
@@ -116,21 +323,49 @@ public:
    */
   virtual size_t maxSize() = 0;
 
+  /**
+   * @brief Returns the exact number of bytes this message will be serialized
+   * into, including its magics and length.
+   *
+   * buildData() calls this on the whole tree right before LogData(), so
+   * implementations can cache anything they computed here for LogData()
+   */
+  virtual size_t encodedSize() = 0;
+
+  /**
+   * @brief Writes the message. Data messages get maxSize() bytes reserved
+   * first, so they write with the unchecked put functions of LogBuffer
+   */
   virtual size_t LogData(LogBuffer *buffer) = 0;
-  virtual std::vector<BaseMessageLogger *> getChildren() = 0;
+  // returned by reference so traversing the tree does not allocate
+  virtual const std::vector<BaseMessageLogger *> &getChildren() = 0;
 
   virtual ~BaseMessageLogger() = default;
 };
 
 class CategoryLogger : public BaseMessageLogger {
-private:
+public:
   static constexpr char basicDataTypeMagic = 0x70;
 
+private:
+  // combined size of the children, from the last encodedSize() call
+  size_t payload_size = 0;
+
 public:
   char getMagic1() override { return basicDataTypeMagic; }
 
   bool IsData() override { return false; }
 
+  size_t encodedSize() override {
+    payload_size = 0;
+    for (auto curr : getChildren()) {
+      payload_size += curr->encodedSize();
+    }
+    return 2 + LogBuffer::varint_size(payload_size) + payload_size;
+  }
+
+  size_t payloadSize() const { return payload_size; }
+
   // since its a structure this should never get called
   size_t LogData(LogBuffer *buffer) override { return 0; }
 };
@@ -143,7 +378,10 @@ public:
   bool IsData() override { return true; }
 
   // this should also never get called
-  std::vector<BaseMessageLogger *> getChildren() override { return {}; };
+  const std::vector<BaseMessageLogger *> &getChildren() override {
+    static const std::vector<BaseMessageLogger *> no_children;
+    return no_children;
+  };
 };
 
 class BoolLogger : public BaseTypeLogger {
@@ -167,10 +405,13 @@ public:
 
   // no data other than the magic
   size_t LogData(LogBuffer *buffer) override {
-    return buffer->write(getMagic2());
+    return buffer->put(getMagic2());
   }
 
-  size_t maxSize() override { return 1; }
+  static constexpr size_t max_size = 1;
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override { return 1; }
 
   ~BoolLogger() override = default;
 };
@@ -191,12 +432,16 @@ public:
   size_t LogData(LogBuffer *buffer) override {
     // for now we dont add the first magic since this a basic type
     size_t len = 0;
-    len += buffer->write(getMagic2());
-    len += buffer->write_varint(data);
+    len += buffer->put(getMagic2());
+    len += buffer->put_varint(data);
     return len;
   }
 
-  size_t maxSize() override { return 1 + sizeof(int32_t); }
+  static constexpr size_t max_size =
+      1 + LogBuffer::max_varint_size<uint32_t>();
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override { return 1 + LogBuffer::varint_size(data); }
 
   ~IntLogger() override = default;
 };
@@ -217,12 +462,16 @@ public:
   size_t LogData(LogBuffer *buffer) override {
     // for now we dont add the first magic since this a basic type
     size_t len = 0;
-    len += buffer->write(getMagic2());
-    len += buffer->write_varint(data);
+    len += buffer->put(getMagic2());
+    len += buffer->put_varint(data);
     return len;
   }
 
-  size_t maxSize() override { return 1 + sizeof(uint32_t); }
+  static constexpr size_t max_size =
+      1 + LogBuffer::max_varint_size<uint32_t>();
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override { return 1 + LogBuffer::varint_size(data); }
 
   ~UIntLogger() override = default;
 };
@@ -243,12 +492,15 @@ public:
   size_t LogData(LogBuffer *buffer) override {
     size_t len = 0;
     // for now we dont add the first magic since this a basic type
-    len += buffer->write(getMagic2());
-    len += buffer->write(data);
+    len += buffer->put(getMagic2());
+    len += buffer->put(data);
     return len;
   }
 
-  size_t maxSize() override { return 1 + sizeof(float); }
+  static constexpr size_t max_size = 1 + sizeof(float);
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override { return maxSize(); }
 
   ~FloatLogger() override = default;
 };
@@ -275,82 +527,420 @@ public:
   size_t LogData(LogBuffer *buffer) override {
     size_t len = 0;
     // for now we dont add the first magic since this a basic type
-    len += buffer->write(getMagic2());
-    len += buffer->write(x);
-    len += buffer->write(y);
-    len += buffer->write(z);
+    len += buffer->put(getMagic2());
+    len += buffer->put(x);
+    len += buffer->put(y);
+    len += buffer->put(z);
     return len;
   }
 
-  size_t maxSize() override { return 1 + 3 * sizeof(float); }
+  static constexpr size_t max_size = 1 + 3 * sizeof(float);
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override { return maxSize(); }
 
   ~PoseLogger() override = default;
 };
 
-// traversing list in dfs order
-// assumes list is getting copied
-inline size_t buildData(BaseMessageLogger *current_message, LogBuffer *buffer) {
-  auto children = current_message->getChildren();
-
+// traversing list in dfs order, sizes must have been computed with
+// encodedSize() first
+inline size_t writeMessage(BaseMessageLogger *current_message,
+                           LogBuffer *buffer) {
   if (current_message->IsData()) {
-    // not a structure, just data
+    // not a structure, just data. Reserving up front means the writes inside
+    // LogData never have to check for room
+    buffer->reserve(current_message->maxSize());
     return current_message->LogData(buffer);
   }
 
+  // anything that is not data is a category
+  size_t data_len =
+      static_cast<CategoryLogger *>(current_message)->payloadSize();
+
   // size of magics and data len
   size_t misc_len = 0;
 
   misc_len += buffer->write(current_message->getMagic1());
   misc_len += buffer->write(current_message->getMagic2());
+  misc_len += buffer->write_varint(data_len);
 
-  size_t data_len_ind = buffer->getIndex();
-  // leave space for length
-  buffer->advanceIndex(4);
-  misc_len += 4;
-
-  size_t data_len = 0;
-
-  for (auto curr : children) {
-    data_len += buildData(curr, buffer);
+  for (auto curr : current_message->getChildren()) {
+    writeMessage(curr, buffer);
   }
 
-  // TODO: switch to varint's
-  buffer->write_index(data_len_ind, data_len);
-
   // total size of the message incuding magics and len data
   return data_len + misc_len;
 }
 
+/**
+ * @brief Serializes a message in two passes: one computing the size of every
+ * nested message, so lengths can be written up front as varints, and one
+ * writing everything in order. size is what message->encodedSize() returned,
+ * for callers that already ran the size pass
+ */
+inline size_t buildData(BaseMessageLogger *message, size_t size,
+                        LogBuffer *buffer) {
+  size_t written = writeMessage(message, buffer);
+  assert((written == size) && "encodedSize does not match written size");
+  return written;
+}
+
+inline size_t buildData(BaseMessageLogger *message, LogBuffer *buffer) {
+  return buildData(message, message->encodedSize(), buffer);
+}
+
+struct SendStats {
+  uint64_t construction_time;
+  uint64_t compress_time;
+  uint64_t send_time;
+  size_t raw_size;
+  size_t compressed_size;
+  // compressed frame plus the packet header and checksum
+  size_t sent_size;
+  uint8_t codec;
+};
+
+/**
+ * @brief Owns the serialization buffer, the compressed buffer and the codec
+ * state so they can be reused across frames.
+ *
+ * Buffers only grow when a frame is larger than anything sent before, so in
+ * steady state send() does not allocate.
+ *
+ * Frames are written in the format described in frame.hpp, each one wrapped
+ * in a packet (see packet.hpp) so receivers can find them in the byte stream.
+ */
+class LogSession {
+private:
+  LogBuffer buf;
+  // only used for frames that did not fit in a single buffer chunk
+  std::vector<char> flattened;
+  std::vector<char> compressed_data;
+
+  LZ4Codec default_codec;
+  Codec *codec = &default_codec;
+  AdaptiveCodecPolicy *policy = nullptr;
+
+  // streaming mode, 0 compresses every frame on its own
+  uint32_t reset_interval = 0;
+  uint32_t frames_since_reset = 0;
+  bool need_reset = true;
+  // raw frames are copied here so LZ4 can reference them in later frames
+  std::unique_ptr<char[]> history;
+  size_t history_size = 0;
+  size_t history_offset = 0;
+  // codec that compressed the previous streamed frame
+  Codec *stream_codec = nullptr;
+
+  static constexpr size_t default_history_size = 2 * frame::max_history;
+
+  // preset dictionary
+  std::span<const char> dictionary;
+  uint32_t dictionary_id = 0;
+
+  uint32_t sequence = 0;
+
+  FdSink default_sink;
+  Sink *sink = &default_sink;
+  bool auto_flush = true;
+
+  // room for both headers before the compressed block
+  static constexpr size_t header_room =
+      packet::max_header_size + frame::max_header_size;
+
+  // copies frame after the previous ones, moving the last frame::max_history
+  // bytes back to the start of the buffer once it is full
+  const char *appendHistory(const LogBuffer &frame, size_t len) {
+    if (history_offset + len > history_size) {
+      size_t needed = frame::max_history + len;
+      if (needed > history_size) {
+        size_t size = std::max(needed, default_history_size);
+        auto bigger = std::make_unique<char[]>(size);
+        history_offset =
+            stream_codec->saveHistory(bigger.get(), frame::max_history);
+        history = std::move(bigger);
+        history_size = size;
+      } else {
+        history_offset =
+            stream_codec->saveHistory(history.get(), frame::max_history);
+      }
+    }
+
+    char *dst = history.get() + history_offset;
+    for (size_t i = 0; i < frame.chunkCount(); i++) {
+      auto chunk = frame.chunk(i);
+      std::memcpy(history.get() + history_offset, chunk.data(), chunk.size());
+      history_offset += chunk.size();
+    }
+    return dst;
+  }
+
+  // up to the last frame::max_history bytes before the next frame
+  std::span<const char> historyWindow() const {
+    size_t size = std::min(history_offset, frame::max_history);
+    return {history.get() + history_offset - size, size};
+  }
+
+  // sets up the codec for the next frame, returns the frame flags
+  uint8_t prepare(Codec &codec) {
+    if (reset_interval == 0) {
+      if (dictionary.empty()) {
+        codec.reset({});
+        return 0;
+      }
+      codec.reset(dictionary, true);
+      return frame::flag_dictionary;
+    }
+
+    uint8_t flags = frame::flag_stream;
+    if (need_reset || frames_since_reset >= reset_interval) {
+      if (history_size < default_history_size) {
+        history = std::make_unique<char[]>(default_history_size);
+        history_size = default_history_size;
+      }
+      history_offset = 0;
+      if (!dictionary.empty()) {
+        // the dictionary becomes the start of the history, so every frame
+        // until it falls out of the window can use it
+        std::memcpy(history.get(), dictionary.data(), dictionary.size());
+        history_offset = dictionary.size();
+        flags |= frame::flag_dictionary;
+      }
+      codec.reset(historyWindow());
+      frames_since_reset = 0;
+      need_reset = false;
+      flags |= frame::flag_reset;
+    } else if (&codec != stream_codec) {
+      // the new codec has not seen the previous frames yet
+      codec.reset(historyWindow());
+    }
+    stream_codec = &codec;
+    frames_since_reset++;
+    return flags;
+  }
+
+  // returns the compressed size, or 0 on failure
+  int compress(Codec &codec, const LogBuffer &frame, size_t raw_size,
+               char *dst, size_t capacity, uint8_t &flags) {
+    flags = prepare(codec);
+    const char *src = reset_interval == 0 ? contiguous(frame, raw_size)
+                                          : appendHistory(frame, raw_size);
+    int size = codec.compress(src, raw_size, dst, capacity);
+
+    // tiny frames can grow, the raw bytes are always an option. Streamed
+    // frames stay in the history of the codec either way
+    if (size == 0 || size >= static_cast<int>(raw_size)) {
+      std::memcpy(dst, src, raw_size);
+      size = raw_size;
+      flags |= frame::codec_none << frame::codec_shift;
+    } else {
+      flags |= codec.id() << frame::codec_shift;
+    }
+    return size;
+  }
+
+  // returns the serialized frame as one contiguous block
+  const char *contiguous(const LogBuffer &frame, size_t len) {
+    if (frame.chunkCount() == 1)
+      return frame.chunk(0).data();
+
+    if (flattened.size() < len)
+      flattened.resize(len);
+    size_t offset = 0;
+    for (size_t i = 0; i < frame.chunkCount(); i++) {
+      auto chunk = frame.chunk(i);
+      std::memcpy(flattened.data() + offset, chunk.data(), chunk.size());
+      offset += chunk.size();
+    }
+    return flattened.data();
+  }
+
+public:
+  LogSession() {}
+
+  LogSession(const LogSession &) = delete;
+  LogSession &operator=(const LogSession &) = delete;
+
+  /**
+   * @brief Compresses every frame with the history of the frames before it,
+   * which helps a lot since consecutive frames are very similar.
+   *
+   * The history is cleared every reset_interval frames so a receiver that
+   * joins mid-stream can sync at the next reset. 0 goes back to compressing
+   * every frame on its own
+   */
+  void setStreaming(uint32_t reset_interval) {
+    this->reset_interval = reset_interval;
+    need_reset = true;
+  }
+
+  bool isStreaming() const { return reset_interval != 0; }
+
+  /**
+   * @brief Compresses frames with a preset dictionary (see dictionary.hpp),
+   * which makes small frames compress much better. The receiver needs the
+   * same dictionary, frames carry its id so a mismatch is detected.
+   *
+   * dictionary must stay alive as long as the session, an empty one goes
+   * back to no dictionary
+   */
+  void setDictionary(std::span<const char> dictionary, uint32_t id) {
+    assert((dictionary.size() <= frame::max_history) &&
+           "dictionary larger than the LZ4 window");
+    this->dictionary = dictionary;
+    dictionary_id = id;
+    need_reset = true;
+  }
+
+  /**
+   * @brief Compresses every frame with codec (see codec.hpp), which must stay
+   * alive as long as the session. Replaces any policy
+   */
+  void setCodec(Codec &codec) {
+    this->codec = &codec;
+    policy = nullptr;
+  }
+
+  /**
+   * @brief Lets policy pick the codec of every frame, nullptr goes back to
+   * the fixed codec
+   */
+  void setCodecPolicy(AdaptiveCodecPolicy *policy) { this->policy = policy; }
+
+  /**
+   * @brief Writes packets to sink instead of stdout, it must stay alive as
+   * long as the session
+   */
+  void setSink(Sink &sink) {
+    this->sink->flush();
+    this->sink = &sink;
+  }
+
+  /**
+   * @brief With auto_flush off packets stay in the sink until flush(), so
+   * several frames can go out in one write
+   */
+  void setAutoFlush(bool auto_flush) { this->auto_flush = auto_flush; }
+
+  bool flush() { return sink->flush(); }
+
+  Sink &getSink() { return *sink; }
+
+  SendStats send(BaseMessageLogger &message) {
+    return send(message, message.encodedSize());
+  }
+
+  /**
+   * @brief Sends a message whose encodedSize() was just called, size is what
+   * it returned
+   */
+  SendStats send(BaseMessageLogger &message, size_t size) {
+    auto start_time = platform::micros();
+    buf.clear();
+    size_t raw_size = buildData(&message, size, &buf);
+    auto end_time = platform::micros();
+
+    return transmit(buf, raw_size, end_time - start_time);
+  }
+
+  /**
+   * @brief Sends a compile time schema message (see schema.hpp)
+   */
+  template <typename M>
+    requires(!std::is_base_of_v<BaseMessageLogger, M>)
+  SendStats send(M &message) {
+    auto start_time = platform::micros();
+    buf.clear();
+    size_t raw_size = message.build(&buf);
+    auto end_time = platform::micros();
+
+    return transmit(buf, raw_size, end_time - start_time);
+  }
+
+  /**
+   * @brief Compresses and sends a frame that was already serialized into
+   * frame, e.g. by another task
+   */
+  SendStats transmit(const LogBuffer &frame, size_t raw_size,
+                     uint64_t construction_time = 0) {
+    assert((raw_size <= frame::max_raw_size) &&
+           "receivers reject frames this large");
+    SendStats stats;
+    stats.raw_size = raw_size;
+    stats.construction_time = construction_time;
+
+    auto compress_start_time = platform::micros();
+    Codec &codec = policy != nullptr ? policy->select(raw_size) : *this->codec;
+    size_t bound = header_room +
+                   std::max<size_t>(codec.bound(raw_size), raw_size) +
+                   packet::checksum_size;
+    if (compressed_data.size() < bound)
+      compressed_data.resize(bound);
+
+    // the header size depends on the varint, so compress right after the
+    // largest possible headers and move the headers next to it
+    char *payload = compressed_data.data() + header_room;
+    uint8_t flags;
+    int payload_size = compress(
+        codec, frame, stats.raw_size, payload,
+        compressed_data.size() - header_room - packet::checksum_size, flags);
+    if (policy != nullptr)
+      policy->record(raw_size, platform::micros() - compress_start_time);
+    stats.codec = frame::codec(flags);
+
+    char header[frame::max_header_size];
+    header[0] = flags;
+    char *header_end = header + 1;
+    if (flags & frame::flag_dictionary) {
+      std::memcpy(header_end, &dictionary_id, sizeof(dictionary_id));
+      header_end += sizeof(dictionary_id);
+    }
+    header_end = LogBuffer::encode_varint(
+        header_end, static_cast<uint32_t>(stats.raw_size));
+    size_t header_size = header_end - header;
+    char *frame_start = payload - header_size;
+    std::memcpy(frame_start, header, header_size);
+
+    int compressed_size = header_size + payload_size;
+    stats.compressed_size = compressed_size;
+    auto compress_end_time = platform::micros();
+    stats.compress_time = compress_end_time - compress_start_time;
+
+    char *packet_start = packet::wrap(frame_start, compressed_size,
+                                      sequence++, stats.codec,
+                                      stats.sent_size);
+
+    // the packet is the only delimiter, no newline after it
+    auto send_start_time = platform::micros();
+    sink->write({packet_start, stats.sent_size});
+    if (auto_flush)
+      sink->flush();
+    auto send_end_time = platform::micros();
+    stats.send_time = send_end_time - send_start_time;
+
+    return stats;
+  }
+};
+
 inline void sendData(BaseMessageLogger *message) {
-  auto start_time = pros::c::micros();
-  LogBuffer buf(message->maxSize() + 200);
-
-  size_t final_size = buildData(message, &buf);
-  auto end_time = pros::c::micros();
-
-  auto compress_start_time = pros::c::micros();
-  // same size as the buf vector
-  std::vector<char> compressed_data(LZ4_compressBound(buf.getVector().size()));
-
-  int compressed_size =
-      LZ4_compress_default(buf.getVector().data(), compressed_data.data(),
-                           final_size, compressed_data.size());
-
-  assert((compressed_size != 0) && "compression failed");
-  compressed_data.resize(compressed_size);
-  auto compress_end_time = pros::c::micros();
-
-  // fine to use endl since we are sending all the data at once
-  auto send_start_time = pros::c::micros();
-  std::cout.write(compressed_data.data(), compressed_size);
-  std::cout << std::endl;
-  auto send_end_time = pros::c::micros();
-
-  std::cout << "total construction time: " << end_time - start_time
-            << ", sending time: " << send_end_time - send_start_time
-            << ", compress time: " << compress_end_time - compress_start_time
-            << ", og/new size: " << final_size << " - " << compressed_size
-            << std::endl;
+  static LogSession session;
+  session.setAutoFlush(false);
+
+  SendStats stats = session.send(*message);
+
+  // same sink as the packet, so both go out in a single write. Receivers skip
+  // the text since it is not a packet
+  char line[160];
+  int len = std::snprintf(
+      line, sizeof(line),
+      "total construction time: %llu, sending time: %llu, compress time: "
+      "%llu, og/new size: %zu - %zu\n",
+      static_cast<unsigned long long>(stats.construction_time),
+      static_cast<unsigned long long>(stats.send_time),
+      static_cast<unsigned long long>(stats.compress_time), stats.raw_size,
+      stats.compressed_size);
+  session.getSink().write({line, static_cast<size_t>(len)});
+  session.flush();
 }
 
 } // namespace logger
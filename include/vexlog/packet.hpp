@@ -0,0 +1,294 @@
+/**
+ * @file
+ * @brief Packets that carry frames over a byte stream, and a decoder that
+ * finds them again after bytes were lost or injected
+ *
+ * Every frame (see frame.hpp) is sent as a packet:
+ *
+ * [sync 1][sync 2](payload size)(sequence)[codec][header check][payload]
+ * [checksum]
+ *
+ * where the header check is the low byte of the xxHash32 of the size,
+ * sequence and codec, and the checksum is the little endian xxHash32 of
+ * everything between the sync word and the checksum. The sequence number
+ * goes up by one for every
+ * packet, so receivers know how many packets they missed. The codec is the
+ * codec id of the frame, so receivers can skip frames they cannot decode
+ * without looking at them.
+ *
+ * A receiver that lost track (dropped bytes, a corrupt length, text printed
+ * in between) looks for the next sync word whose packet has a valid
+ * checksum, which takes about one packet worth of bytes. The header check
+ * rejects most false sync words right away, so a garbage size rarely makes
+ * the receiver wait for a payload that is not there.
+ */
+
+#pragma once
+
+#include "frame.hpp"
+#include "lz4/xxhash.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace vexmaps {
+namespace logger {
+namespace packet {
+
+constexpr uint8_t sync1 = 0xa5;
+constexpr uint8_t sync2 = 0x5a;
+
+// sync word, two 32 bit varints, the codec and the header check
+constexpr size_t max_header_size = 2 + 5 + 5 + 1 + 1;
+constexpr size_t checksum_size = 4;
+
+// larger sizes are taken as corrupt instead of waiting for that many bytes
+constexpr size_t default_max_payload = frame::bound(frame::max_raw_size);
+
+inline uint32_t checksum(const char *data, size_t len) {
+  return XXH32(data, len, 0);
+}
+
+// of the header between the sync word and the header check
+inline uint8_t header_check(const char *data, size_t len) {
+  return static_cast<uint8_t>(checksum(data, len));
+}
+
+/**
+ * @brief Turns the payload into a packet in place, the header goes into the
+ * max_header_size bytes before payload and the checksum into the
+ * checksum_size bytes after it
+ *
+ * @return start of the packet
+ */
+inline char *wrap(char *payload, size_t size, uint32_t sequence,
+                  uint8_t codec, size_t &packet_size) {
+  char header[max_header_size];
+  header[0] = static_cast<char>(sync1);
+  header[1] = static_cast<char>(sync2);
+  char *end = header + 2;
+  for (uint32_t v : {static_cast<uint32_t>(size), sequence}) {
+    while (v >= 128) {
+      *end++ = static_cast<char>(v | 128);
+      v >>= 7;
+    }
+    *end++ = static_cast<char>(v);
+  }
+  *end++ = static_cast<char>(codec);
+  *end = static_cast<char>(header_check(header + 2, end - header - 2));
+  end++;
+
+  size_t header_size = end - header;
+  char *start = payload - header_size;
+  std::memcpy(start, header, header_size);
+
+  uint32_t sum = checksum(start + 2, header_size - 2 + size);
+  for (size_t i = 0; i < checksum_size; i++)
+    payload[size + i] = static_cast<char>(sum >> (8 * i));
+
+  packet_size = header_size + size + checksum_size;
+  return start;
+}
+
+/**
+ * @brief Payload of a whole packet made by wrap(), e.g. to wrap it again with
+ * another sequence number
+ */
+inline std::span<const char> payload(std::span<const char> packet,
+                                     uint8_t &codec) {
+  size_t i = 2;
+  // size and sequence
+  for (int varint = 0; varint < 2; varint++)
+    while (static_cast<uint8_t>(packet[i++]) & 128)
+      ;
+  codec = packet[i++];
+  // header check
+  i++;
+  return packet.subspan(i, packet.size() - i - checksum_size);
+}
+
+} // namespace packet
+
+/**
+ * @brief Finds packets in a byte stream.
+ *
+ * Bytes are pushed as they arrive, in pieces of any size, and every complete
+ * packet is returned once by next(). Bytes that do not belong to a valid
+ * packet are skipped.
+ */
+class PacketDecoder {
+public:
+  struct Packet {
+    uint32_t sequence;
+    uint8_t codec;
+    // packets missing right before this one, streamed frames after a gap
+    // cannot be decoded until the next reset (see FrameDecoder::frameLost)
+    uint32_t lost;
+    // valid until the next push()
+    std::span<const char> payload;
+  };
+
+private:
+  std::vector<char> pending;
+  size_t start = 0;
+  size_t max_payload;
+
+  bool have_sequence = false;
+  uint32_t last_sequence = 0;
+
+  uint32_t packets = 0;
+  uint32_t lost_packets = 0;
+  uint32_t corrupt_packets = 0;
+  uint64_t skipped_bytes = 0;
+
+  // false if the varint is not complete yet, or too long
+  bool readVarint(size_t &i, uint32_t &value, bool &valid) const {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      if (i >= pending.size())
+        return false;
+      uint8_t byte = pending[i++];
+      value |= static_cast<uint32_t>(byte & 127) << shift;
+      if (!(byte & 128))
+        return true;
+    }
+    valid = false;
+    return false;
+  }
+
+  // moves start to the first sync word at or after from
+  void skip(size_t from) {
+    const size_t end = pending.size();
+    size_t i = from;
+    while (i < end) {
+      const void *found =
+          std::memchr(pending.data() + i, packet::sync1, end - i);
+      if (found == nullptr) {
+        i = end;
+        break;
+      }
+      i = static_cast<const char *>(found) - pending.data();
+      // the second half may not have arrived yet
+      if (i + 1 == end ||
+          static_cast<uint8_t>(pending[i + 1]) == packet::sync2)
+        break;
+      i++;
+    }
+    skipped_bytes += i - start;
+    start = i;
+  }
+
+public:
+  /**
+   * @param max_payload largest payload accepted, anything larger is treated as
+   * a corrupt header. Receivers that know their largest message can pass
+   * frame::bound(maxSize()) to resync faster
+   */
+  PacketDecoder(size_t max_payload = packet::default_max_payload)
+      : max_payload(max_payload) {}
+
+  /**
+   * @brief Adds received bytes, invalidates the payload of earlier packets
+   */
+  void push(std::span<const char> data) {
+    // drop what was already consumed once it is most of the buffer
+    if (start > 0 && start >= pending.size() / 2) {
+      pending.erase(pending.begin(), pending.begin() + start);
+      start = 0;
+    }
+    pending.insert(pending.end(), data.begin(), data.end());
+  }
+
+  /**
+   * @brief Returns the next complete packet, false if more bytes are needed
+   */
+  bool next(Packet &packet) {
+    while (true) {
+      skip(start);
+      if (pending.size() - start < 2)
+        return false;
+
+      size_t i = start + 2;
+      uint32_t size;
+      uint32_t sequence;
+      bool valid = true;
+      if (!readVarint(i, size, valid) || !readVarint(i, sequence, valid)) {
+        if (valid)
+          return false;
+        // not a packet, just a sync word inside something else
+        skip(start + 1);
+        continue;
+      }
+      if (size > max_payload) {
+        skip(start + 1);
+        continue;
+      }
+      if (pending.size() - i < 2)
+        return false;
+      uint8_t codec = pending[i++];
+      // checked before waiting for the payload of what may be a false sync
+      if (static_cast<uint8_t>(pending[i]) !=
+          packet::header_check(pending.data() + start + 2, i - start - 2)) {
+        corrupt_packets++;
+        skip(start + 1);
+        continue;
+      }
+      i++;
+      if (pending.size() - i < size + packet::checksum_size)
+        return false;
+
+      const char *payload = pending.data() + i;
+      uint32_t expected = 0;
+      for (size_t k = 0; k < packet::checksum_size; k++)
+        expected |= static_cast<uint32_t>(static_cast<uint8_t>(
+                        payload[size + k]))
+                    << (8 * k);
+      if (packet::checksum(pending.data() + start + 2,
+                           payload + size - pending.data() - start - 2) !=
+          expected) {
+        corrupt_packets++;
+        skip(start + 1);
+        continue;
+      }
+
+      packet.sequence = sequence;
+      packet.codec = codec;
+      packet.payload = {payload, size};
+      packet.lost = 0;
+      // a jump backwards means the sender restarted
+      uint32_t gap = sequence - last_sequence - 1;
+      if (have_sequence && gap < (1u << 31))
+        packet.lost = gap;
+      lost_packets += packet.lost;
+      last_sequence = sequence;
+      have_sequence = true;
+      packets++;
+
+      start = payload + size + packet::checksum_size - pending.data();
+      return true;
+    }
+  }
+
+  uint32_t receivedPackets() const { return packets; }
+
+  /**
+   * @brief Packets that never arrived, from gaps in the sequence numbers
+   */
+  uint32_t lostPackets() const { return lost_packets; }
+
+  /**
+   * @brief Packets whose header check or checksum did not match (or sync
+   * words found inside other data)
+   */
+  uint32_t corruptPackets() const { return corrupt_packets; }
+
+  /**
+   * @brief Bytes that were not part of any valid packet
+   */
+  uint64_t skippedBytes() const { return skipped_bytes; }
+};
+
+} // namespace logger
+} // namespace vexmaps
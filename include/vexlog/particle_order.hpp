@@ -0,0 +1,174 @@
+/**
+ * @file
+ * @brief Reorders particles along a space filling curve before delta coding
+ *
+ * The order of the particles means nothing to the viewer, but delta coding
+ * works much better when consecutive particles are close to each other. The
+ * positions are quantized to a 2^grid_bits square grid over their bounds and
+ * sorted by the Morton (Z order) or Hilbert index of their cell with a two
+ * pass radix sort, which needs no heap and takes the same time whatever the
+ * input order.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace vexmaps {
+namespace logger {
+
+enum class ParticleOrder {
+  // as given to addParticles
+  Input,
+  // Z order, cheapest key
+  Morton,
+  // no jumps between distant cells, so slightly smaller deltas
+  Hilbert
+};
+
+namespace particle_order {
+
+// cells per axis, 2 radix passes of grid_bits each
+constexpr int grid_bits = 10;
+constexpr uint32_t grid_size = 1 << grid_bits;
+
+// spreads the low 16 bits of v to the even bits
+inline uint32_t spreadBits(uint32_t v) {
+  v &= 0xffff;
+  v = (v | (v << 8)) & 0x00ff00ff;
+  v = (v | (v << 4)) & 0x0f0f0f0f;
+  v = (v | (v << 2)) & 0x33333333;
+  v = (v | (v << 1)) & 0x55555555;
+  return v;
+}
+
+inline uint32_t morton_key(uint32_t x, uint32_t y) {
+  return spreadBits(x) | (spreadBits(y) << 1);
+}
+
+// branch free version of the usual quadrant rotating loop, the rotations of
+// every level are found with a parallel prefix scan over the bits (see
+// threadlocalmutex.com/?p=126)
+inline uint32_t hilbert_key(uint32_t x, uint32_t y) {
+  x <<= 16 - grid_bits;
+  y <<= 16 - grid_bits;
+
+  uint32_t A, B, C, D;
+  {
+    uint32_t a = x ^ y;
+    uint32_t b = 0xffff ^ a;
+    uint32_t c = 0xffff ^ (x | y);
+    uint32_t d = x & (y ^ 0xffff);
+    A = a | (b >> 1);
+    B = (a >> 1) ^ a;
+    C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+  }
+  for (int shift = 2; shift <= 8; shift *= 2) {
+    uint32_t a = A;
+    uint32_t b = B;
+    uint32_t c = C;
+    uint32_t d = D;
+    A = (a & (a >> shift)) ^ (b & (b >> shift));
+    B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+    C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+    D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+  }
+
+  uint32_t a = C ^ (C >> 1);
+  uint32_t b = D ^ (D >> 1);
+  uint32_t i0 = x ^ y;
+  uint32_t i1 = b | (0xffff ^ (i0 | a));
+  return ((spreadBits(i1) << 1) | spreadBits(i0)) >> (32 - 2 * grid_bits);
+}
+
+/**
+ * @brief Sorts the particles along a curve
+ *
+ * @param entries room for 2 * n entries
+ * @return n entries in curve order, the low 32 bits of each are the index of
+ * a particle
+ */
+inline const uint64_t *sort(ParticleOrder order, const float *x,
+                            const float *y, size_t n,
+                            std::pair<float, float> x_bounds,
+                            std::pair<float, float> y_bounds,
+                            uint64_t *entries) {
+  // just below grid_size so the largest value still lands in the last cell
+  const float cells = grid_size - 0.01f;
+  const float x_scale = x_bounds.second > x_bounds.first
+                            ? cells / (x_bounds.second - x_bounds.first)
+                            : 0;
+  const float y_scale = y_bounds.second > y_bounds.first
+                            ? cells / (y_bounds.second - y_bounds.first)
+                            : 0;
+
+  // kept apart from the histograms so the compiler can vectorize it
+  auto makeKeys = [&](auto curve_key) {
+    for (size_t i = 0; i < n; i++) {
+      uint32_t cx = static_cast<uint32_t>((x[i] - x_bounds.first) * x_scale);
+      uint32_t cy = static_cast<uint32_t>((y[i] - y_bounds.first) * y_scale);
+      entries[i] = (static_cast<uint64_t>(curve_key(cx, cy)) << 32) | i;
+    }
+  };
+  // lambdas so each loop gets its own inlined key function
+  if (order == ParticleOrder::Hilbert)
+    makeKeys([](uint32_t x, uint32_t y) { return hilbert_key(x, y); });
+  else
+    makeKeys([](uint32_t x, uint32_t y) { return morton_key(x, y); });
+
+  // histograms of both radix digits in one go
+  uint32_t counts[2][grid_size];
+  std::memset(counts, 0, sizeof(counts));
+  for (size_t i = 0; i < n; i++) {
+    uint32_t key = entries[i] >> 32;
+    counts[0][key & (grid_size - 1)]++;
+    counts[1][key >> grid_bits]++;
+  }
+
+  // stable LSD radix sort, one pass per grid_bits of the key
+  uint64_t *in = entries;
+  uint64_t *out = entries + n;
+  for (int pass = 0; pass < 2; pass++) {
+    const int shift = 32 + pass * grid_bits;
+    uint32_t *offsets = counts[pass];
+
+    uint32_t start = 0;
+    for (uint32_t d = 0; d < grid_size; d++) {
+      uint32_t count = offsets[d];
+      offsets[d] = start;
+      start += count;
+    }
+
+    for (size_t i = 0; i < n; i++)
+      out[offsets[(in[i] >> shift) & (grid_size - 1)]++] = in[i];
+    std::swap(in, out);
+  }
+  return in;
+}
+
+/**
+ * @brief Sort buffers and the reordered input of N particles. Loggers only
+ * point to one once they are given an order, so the ones sent in input
+ * order do not carry it
+ */
+template <size_t N> struct Scratch {
+  uint64_t entries[2 * N];
+  float gathered[N];
+};
+
+/**
+ * @brief out[i] = data[index of sorted[i]]
+ */
+inline void gather(const float *data, const uint64_t *sorted, size_t n,
+                   float *out) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = data[static_cast<uint32_t>(sorted[i])];
+}
+
+} // namespace particle_order
+} // namespace logger
+} // namespace vexmaps
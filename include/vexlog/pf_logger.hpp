@@ -3,8 +3,19 @@
  * @brief Particle Filter specific messages
  */
 
+#pragma once
+
+#include "bitpack.hpp"
 #include "float_compression.hpp"
 #include "logger.hpp"
+#include "particle_order.hpp"
+#include "rans.hpp"
+#include "schema.hpp"
+#include "stream_vbyte.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
 #include <utility>
 
 // TODO: put all magics in one place
@@ -20,6 +31,8 @@ private:
 
   static constexpr char particleLoggerMagic = 0x41;
 
+  size_t payload_size = 0;
+
 public:
   char getMagic2() override { return particleLoggerMagic; }
 
@@ -36,30 +49,21 @@ public:
 
     for (size_t i = offset; i < remaining_particles; i += 8) {
       // load in values
-      float32x4_t vx1 = vld1q_f32(&x[i]);
-      float32x4_t vy1 = vld1q_f32(&y[i]);
-      float32x4_t vweights1 = vld1q_f32(&weights[i]);
-
-      float32x4_t vx2 = vld1q_f32(&x[i + 4]);
-      float32x4_t vy2 = vld1q_f32(&y[i + 4]);
-      float32x4_t vweights2 = vld1q_f32(&weights[i + 4]);
-
-      // convert to float16
-      float16x4_t v16x1 = vcvt_f16_f32(vx1);
-      float16x4_t v16y1 = vcvt_f16_f32(vy1);
-      float16x4_t v16weights1 = vcvt_f16_f32(vweights1);
-
-      float16x4_t v16x2 = vcvt_f16_f32(vx2);
-      float16x4_t v16y2 = vcvt_f16_f32(vy2);
-      float16x4_t v16weights2 = vcvt_f16_f32(vweights2);
-
-      // load to internal arrays
-      vst1_f16(&(this->x[i]), v16x1);
-      vst1_f16(&(this->y[i]), v16y1);
-      vst1_f16(&(this->weights[i]), v16weights1);
-      vst1_f16(&(this->x[i + 4]), v16x2);
-      vst1_f16(&(this->y[i + 4]), v16y2);
-      vst1_f16(&(this->weights[i + 4]), v16weights2);
+      simd::f32x4 vx1 = simd::load(&x[i]);
+      simd::f32x4 vy1 = simd::load(&y[i]);
+      simd::f32x4 vweights1 = simd::load(&weights[i]);
+
+      simd::f32x4 vx2 = simd::load(&x[i + 4]);
+      simd::f32x4 vy2 = simd::load(&y[i + 4]);
+      simd::f32x4 vweights2 = simd::load(&weights[i + 4]);
+
+      // convert to float16 and store in internal arrays
+      simd::store_f16(&(this->x[i]), vx1);
+      simd::store_f16(&(this->y[i]), vy1);
+      simd::store_f16(&(this->weights[i]), vweights1);
+      simd::store_f16(&(this->x[i + 4]), vx2);
+      simd::store_f16(&(this->y[i + 4]), vy2);
+      simd::store_f16(&(this->weights[i + 4]), vweights2);
     }
     for (size_t i = remaining_particles; i < min_n; i++) {
       this->x[i] = x[i];
@@ -81,39 +85,39 @@ public:
     // total len
     size_t misc_len = 0;
 
-    misc_len += buffer->write(getMagic1());
-    misc_len += buffer->write(getMagic2());
+    misc_len += buffer->put(getMagic1());
+    misc_len += buffer->put(getMagic2());
 
-    size_t data_len_ind = buffer->getIndex();
-
-    // leave space for len
-    buffer->advanceIndex(4);
-    misc_len += 4;
+    misc_len += buffer->put_varint(payload_size);
 
     size_t data_len = 0;
     for (int i = 0; i < N; i++) {
-      data_len += buffer->write(x[i]);
-      data_len += buffer->write(y[i]);
-      data_len += buffer->write(weights[i]);
+      data_len += buffer->put(x[i]);
+      data_len += buffer->put(y[i]);
+      data_len += buffer->put(weights[i]);
     }
 
-    buffer->write_index(data_len_ind, data_len);
-
     return misc_len + data_len;
   }
 
   // two bytes per particle
-  size_t maxSize() override {
-    return 2 + sizeof(uint32_t) + 3 * N * sizeof(float16_t);
+  static constexpr size_t max_size =
+      2 + LogBuffer::max_varint_size<uint32_t>() + 3 * N * sizeof(float16_t);
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override {
+    payload_size = 3 * N * sizeof(float16_t);
+    return 2 + LogBuffer::varint_size(payload_size) + payload_size;
   }
 
   ~Float16ParticlesLogger() override = default;
 };
 
 class DistanceSensorLogger : public CategoryLogger {
-private:
+public:
   static constexpr char distanceInfoMagic = 0x42;
 
+private:
   std::vector<BaseMessageLogger *> children{&identifier, &measured_distance,
                                             &confidence, &object_size, &exit};
 
@@ -136,7 +140,9 @@ public:
 
   char getMagic2() override { return distanceInfoMagic; }
 
-  std::vector<BaseMessageLogger *> getChildren() override { return children; };
+  const std::vector<BaseMessageLogger *> &getChildren() override {
+    return children;
+  };
 
   size_t maxSize() override {
     size_t len = 0;
@@ -152,7 +158,7 @@ public:
 // implements a different logger for particles that instead uses int
 // representations for floats as well as varints
 template <size_t N> class VarintParticlesLogger : public BaseTypeLogger {
-private:
+protected:
   int16_t x[N];
   int16_t y[N];
   int16_t weights[N];
@@ -163,117 +169,774 @@ private:
   uint32_t y_mod;
   uint32_t weights_mod;
 
+  // computed by encodedSize()
+  size_t payload_size = 0;
+
+  ParticleOrder order = ParticleOrder::Input;
+  // given with the order, see setOrder
+  particle_order::Scratch<N> *order_scratch = nullptr;
+
+  // largest error of a position in meters, and of a weight relative to the
+  // largest weight
+  float position_error = 0.25f * 0.0254f;
+  float weight_error = 1.0f / (1 << 14);
+
+  // smallest mods that keep the errors, needs the bounds
+  void chooseMods() {
+    x_mod = error_bounded_mod(x_bounds.first, x_bounds.second, position_error);
+    y_mod = error_bounded_mod(y_bounds.first, y_bounds.second, position_error);
+    float largest_weight = std::max(std::abs(weight_bounds.first),
+                                    std::abs(weight_bounds.second));
+    weights_mod = error_bounded_mod(weight_bounds.first, weight_bounds.second,
+                                    weight_error * largest_weight);
+  }
+
+  size_t boundsSize() {
+    return 6 * sizeof(float) + LogBuffer::varint_size(x_mod) +
+           LogBuffer::varint_size(y_mod) + LogBuffer::varint_size(weights_mod);
+  }
+
+  // the steps every logger that quantizes like this one shares: the bounds,
+  // the mods and the order. quantize(data, out, bounds, mod) then runs for x,
+  // y and the weights in turn, with data in the order it is sent in
+  template <typename Quantize>
+  void quantizeParticles(float *x, float *y, float *weights, const size_t len,
+                         Quantize quantize) {
+    // since we rely on delta encoding we must have all the values right now
+    assert((len == N) && "must give the same amount of particles");
+
+    // calculate bounds, one sweep over all three arrays
+    std::pair<float, float> bounds[3];
+    float_bounds({x, y, weights}, N, bounds);
+    x_bounds = bounds[0];
+    y_bounds = bounds[1];
+    weight_bounds = bounds[2];
+
+    chooseMods();
+
+    const uint64_t *sorted = nullptr;
+    if (order != ParticleOrder::Input)
+      sorted = particle_order::sort(order, x, y, N, x_bounds, y_bounds,
+                                    order_scratch->entries);
+    // the reordered array if there is an order, one array at a time
+    auto ordered = [&](float *data) {
+      if (sorted == nullptr)
+        return data;
+      particle_order::gather(data, sorted, N, order_scratch->gathered);
+      return order_scratch->gathered;
+    };
+
+    quantize(ordered(x), this->x, x_bounds, x_mod);
+    quantize(ordered(y), this->y, y_bounds, y_mod);
+    quantize(ordered(weights), this->weights, weight_bounds, weights_mod);
+  }
+
+  // write bounds for each category
+  size_t writeBounds(LogBuffer *buffer) {
+    size_t len = 0;
+    len += buffer->put(x_bounds.first);
+    len += buffer->put(x_bounds.second);
+    len += buffer->put_varint(x_mod);
+
+    len += buffer->put(y_bounds.first);
+    len += buffer->put(y_bounds.second);
+    len += buffer->put_varint(y_mod);
+
+    len += buffer->put(weight_bounds.first);
+    len += buffer->put(weight_bounds.second);
+    len += buffer->put_varint(weights_mod);
+    return len;
+  }
+
+private:
   static constexpr char particleLoggerMagic = 0x49;
 
 public:
   char getMagic2() override { return particleLoggerMagic; }
 
+  /**
+   * @brief Sorts the particles along a space filling curve before delta
+   * coding them, which makes the x/y deltas much smaller. The viewer does not
+   * care about the order, but particles are not sent in the order given to
+   * addParticles anymore
+   *
+   * @param scratch sort buffers, needed for any order but
+   * ParticleOrder::Input. Only one logger can use it at a time
+   */
+  void setOrder(ParticleOrder order,
+                particle_order::Scratch<N> *scratch = nullptr) {
+    assert((order == ParticleOrder::Input || scratch != nullptr) &&
+           "an order needs sort buffers");
+    this->order = order;
+    order_scratch = scratch;
+  }
+
+  /**
+   * @brief Sets the largest error allowed after quantization
+   *
+   * @param position in meters, 0.25 inches by default
+   * @param relative_weight as a fraction of the largest weight of the
+   * generation, 1 / 2^14 by default
+   */
+  void setMaxError(float position, float relative_weight) {
+    position_error = position;
+    weight_error = relative_weight;
+  }
+
   // TODO: switch to maybe only doing the delta encoding when we are building
   // the message to enable point updates
   void addParticles(float *x, float *y, float *weights, const size_t len) {
-    // since we rely on delta encoding we must have all the values right now
-    assert((len == N) && "must give the same amount of particles");
+    // weights have to be somewhat precise because they do have a high range
+    // however it could greatly benefit from delta's since most weights will be
+    // small
+    quantizeParticles(x, y, weights, len,
+                      [](float *data, int16_t *out,
+                         std::pair<float, float> bounds, uint32_t mod) {
+                        compress_floats(data, out, N, bounds.first,
+                                        bounds.second, mod);
+                      });
+  }
 
-    // calculate bounds
-    x_bounds.first = x_bounds.second = x[0];
-    y_bounds.first = y_bounds.second = y[0];
-    weight_bounds.first = weight_bounds.second = weights[0];
+  size_t LogData(LogBuffer *buffer) override {
+    // total len
+    size_t misc_len = 0;
 
-    // TODO: vectorize
-    for (int i = 1; i < N; i++) {
-      x_bounds.first = std::min(x[i], x_bounds.first);
-      x_bounds.second = std::max(x[i], x_bounds.second);
+    misc_len += buffer->put(getMagic1());
+    misc_len += buffer->put(getMagic2());
 
-      y_bounds.first = std::min(y[i], y_bounds.first);
-      y_bounds.second = std::max(y[i], y_bounds.second);
+    misc_len += buffer->put_varint(payload_size);
 
-      weight_bounds.first = std::min(weights[i], weight_bounds.first);
-      weight_bounds.second = std::max(weights[i], weight_bounds.second);
-    }
+    size_t data_len = 0;
+    data_len += writeBounds(buffer);
+
+    data_len += buffer->put_varint_array(x, N);
+    data_len += buffer->put_varint_array(y, N);
+    data_len += buffer->put_varint_array(weights, N);
 
-    float x_difference = x_bounds.second - x_bounds.first;
-    float y_difference = y_bounds.second - y_bounds.first;
-    float weight_difference = weight_bounds.second - weight_bounds.first;
+    return misc_len + data_len;
+  }
 
-    // aiming for a 0.25 inch error
-    // difference / x = 0.2
-    // difference * 4 = x
+  // at most three bytes per particle
+  static constexpr size_t max_size = 2 * sizeof(char) +  // magic
+                                     5 +                 // len
+                                     6 * sizeof(float) + // bounds
+                                     3 * 5 +             // mods
+                                     3 * N * 3;          // particles
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override {
+    payload_size = boundsSize() + LogBuffer::varint_array_size(x, N) +
+                   LogBuffer::varint_array_size(y, N) +
+                   LogBuffer::varint_array_size(weights, N);
+    return 2 + LogBuffer::varint_size(payload_size) + payload_size;
+  }
 
-    // equivalent to the floor(log2) - means error might be higher than expected
-    uint32_t x_mod = static_cast<uint32_t>(4 * x_difference / 0.0254);
-    uint32_t y_mod = static_cast<uint32_t>(4 * y_difference / 0.0254);
+  ~VarintParticlesLogger() override = default;
+};
 
-    x_mod =
-        compress_floats(x, this->x, N, x_bounds.first, x_bounds.second, x_mod);
-    y_mod =
-        compress_floats(y, this->y, N, y_bounds.first, y_bounds.second, y_mod);
+// same quantization as VarintParticlesLogger, but each array is written as
+// stream vbyte groups, which are much faster to encode and decode than byte by
+// byte varints
+//
+// [bounds, same as VarintParticlesLogger](N)[x groups][y groups][weight groups]
+template <size_t N>
+class StreamVByteParticlesLogger : public VarintParticlesLogger<N> {
+private:
+  static constexpr char particleLoggerMagic = 0x4a;
 
-    // weights have to be somewhat precise because they do have a high range
-    // however it could greatly benefit from delta's since most weights will be
-    // small
-    weights_mod = compress_floats(weights, this->weights, N,
-                                  weight_bounds.first, weight_bounds.second);
+  size_t writeGroups(LogBuffer *buffer, const int16_t *data) {
+    char *out = buffer->claim(stream_vbyte::max_size(N) + stream_vbyte::slack);
+    size_t len =
+        stream_vbyte::encode(data, N, reinterpret_cast<uint8_t *>(out));
+    buffer->commit(len);
+    return len;
   }
 
+public:
+  char getMagic2() override { return particleLoggerMagic; }
+
   size_t LogData(LogBuffer *buffer) override {
     // total len
     size_t misc_len = 0;
 
-    misc_len += buffer->write(getMagic1());
-    misc_len += buffer->write(getMagic2());
+    misc_len += buffer->put(this->getMagic1());
+    misc_len += buffer->put(getMagic2());
 
-    size_t data_len_ind = buffer->getIndex();
+    misc_len += buffer->put_varint(this->payload_size);
 
-    // leave space for len
-    buffer->advanceIndex(4);
-    misc_len += 4;
+    size_t data_len = 0;
+    data_len += this->writeBounds(buffer);
+    data_len += buffer->put_varint(static_cast<uint32_t>(N));
+
+    data_len += writeGroups(buffer, this->x);
+    data_len += writeGroups(buffer, this->y);
+    data_len += writeGroups(buffer, this->weights);
+
+    return misc_len + data_len;
+  }
+
+  static constexpr size_t max_size =
+      2 * sizeof(char) +              // magic
+      5 +                             // len
+      6 * sizeof(float) +             // bounds
+      3 * 5 + 5 +                     // mods and N
+      3 * stream_vbyte::max_size(N) + // particles
+      stream_vbyte::slack;
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override {
+    this->payload_size =
+        this->boundsSize() + LogBuffer::varint_size(static_cast<uint32_t>(N)) +
+        stream_vbyte::encoded_size(this->x, N) +
+        stream_vbyte::encoded_size(this->y, N) +
+        stream_vbyte::encoded_size(this->weights, N);
+    return 2 + LogBuffer::varint_size(this->payload_size) + this->payload_size;
+  }
+
+  ~StreamVByteParticlesLogger() override = default;
+};
+
+// same quantization as VarintParticlesLogger, but each delta array is bit
+// packed in blocks of 128 (see bitpack.hpp), which the host unpacks without
+// looking at individual values
+template <size_t N>
+class BitPackedParticlesLogger : public VarintParticlesLogger<N> {
+private:
+  static constexpr char particleLoggerMagic = 0x4d;
+
+  size_t writeBlocks(LogBuffer *buffer, const int16_t *data) {
+    char *out = buffer->claim(bitpack::max_size(N));
+    size_t len = bitpack::encode(data, N, reinterpret_cast<uint8_t *>(out));
+    buffer->commit(len);
+    return len;
+  }
+
+public:
+  char getMagic2() override { return particleLoggerMagic; }
+
+  size_t LogData(LogBuffer *buffer) override {
+    // total len
+    size_t misc_len = 0;
+
+    misc_len += buffer->put(this->getMagic1());
+    misc_len += buffer->put(getMagic2());
+
+    misc_len += buffer->put_varint(this->payload_size);
 
     size_t data_len = 0;
-    // write bounds for each category
-    data_len += buffer->write(x_bounds.first);
-    data_len += buffer->write(x_bounds.second);
-    data_len += buffer->write_varint(x_mod);
+    data_len += this->writeBounds(buffer);
+    data_len += buffer->put_varint(static_cast<uint32_t>(N));
 
-    data_len += buffer->write(y_bounds.first);
-    data_len += buffer->write(y_bounds.second);
-    data_len += buffer->write_varint(y_mod);
+    data_len += writeBlocks(buffer, this->x);
+    data_len += writeBlocks(buffer, this->y);
+    data_len += writeBlocks(buffer, this->weights);
 
-    data_len += buffer->write(weight_bounds.first);
-    data_len += buffer->write(weight_bounds.second);
-    data_len += buffer->write_varint(weights_mod);
+    return misc_len + data_len;
+  }
 
-    for (int i = 0; i < N; i++) {
-      data_len += buffer->write_varint(x[i]);
+  static constexpr size_t max_size =
+      2 * sizeof(char) +         // magic
+      5 +                        // len
+      6 * sizeof(float) +        // bounds
+      3 * 5 + 5 +                // mods and N
+      3 * bitpack::max_size(N); // particles
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override {
+    this->payload_size =
+        this->boundsSize() + LogBuffer::varint_size(static_cast<uint32_t>(N)) +
+        bitpack::encoded_size(this->x, N) + bitpack::encoded_size(this->y, N) +
+        bitpack::encoded_size(this->weights, N);
+    return 2 + LogBuffer::varint_size(this->payload_size) + this->payload_size;
+  }
+
+  ~BitPackedParticlesLogger() override = default;
+};
+
+// same quantization as VarintParticlesLogger, but each delta array is
+// entropy coded with rANS (see rans.hpp), each with its own frequency table.
+// The arrays are coded in addParticles() since their size is only known
+// after coding them. Frames are about a quarter smaller than varints with
+// LZ4, but take about 1.4 times as long to decode (`vexlog --bench`), so it
+// is worth it when the link is the bottleneck
+//
+// [bounds, same as VarintParticlesLogger](N)[x stream][y stream][weight stream]
+template <size_t N>
+class RansParticlesLogger : public VarintParticlesLogger<N> {
+private:
+  static constexpr char particleLoggerMagic = 0x4c;
+
+  uint8_t encoded[3][rans::max_size(N)];
+  size_t encoded_size[3] = {};
+  uint8_t tokens[N];
+
+public:
+  char getMagic2() override { return particleLoggerMagic; }
+
+  void addParticles(float *x, float *y, float *weights, const size_t len) {
+    VarintParticlesLogger<N>::addParticles(x, y, weights, len);
+
+    encoded_size[0] = rans::encode(this->x, N, encoded[0], tokens);
+    encoded_size[1] = rans::encode(this->y, N, encoded[1], tokens);
+    encoded_size[2] = rans::encode(this->weights, N, encoded[2], tokens);
+  }
+
+  size_t LogData(LogBuffer *buffer) override {
+    // total len
+    size_t misc_len = 0;
+
+    misc_len += buffer->put(this->getMagic1());
+    misc_len += buffer->put(getMagic2());
+
+    misc_len += buffer->put_varint(this->payload_size);
+
+    size_t data_len = 0;
+    data_len += this->writeBounds(buffer);
+    data_len += buffer->put_varint(static_cast<uint32_t>(N));
+
+    for (int i = 0; i < 3; i++)
+      data_len += buffer->put_bytes(
+          {reinterpret_cast<const char *>(encoded[i]), encoded_size[i]});
+
+    return misc_len + data_len;
+  }
+
+  static constexpr size_t max_size = 2 * sizeof(char) +  // magic
+                                     5 +                 // len
+                                     6 * sizeof(float) + // bounds
+                                     3 * 5 + 5 +         // mods and N
+                                     3 * rans::max_size(N); // particles
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override {
+    this->payload_size = this->boundsSize() +
+                         LogBuffer::varint_size(static_cast<uint32_t>(N)) +
+                         encoded_size[0] + encoded_size[1] + encoded_size[2];
+    return 2 + LogBuffer::varint_size(this->payload_size) + this->payload_size;
+  }
+
+  ~RansParticlesLogger() override = default;
+};
+
+// same quantization as VarintParticlesLogger, but identical particles (same
+// quantized x, y and weight) are sent once with a repeat count. Resampling
+// copies the likely particles many times, so a converged filter only has a
+// handful of distinct ones.
+//
+// [bounds](N)(unique count)[x deltas][y deltas][weight deltas][counts]
+//
+// where the deltas are of the unique particles, in order of first appearance.
+// Counts add up to N, decoders can repeat every particle count times or keep
+// the count as an extra weight
+template <size_t N>
+class DedupParticlesLogger : public VarintParticlesLogger<N> {
+private:
+  static constexpr char particleLoggerMagic = 0x4e;
+
+  // open addressing, unique index + 1 or 0 when empty
+  static constexpr size_t table_size = std::bit_ceil(2 * N);
+  uint32_t table[table_size];
+
+  uint32_t counts[N];
+  size_t unique = 0;
+
+  static float quantizationScale(float difference, uint32_t mod) {
+    // a converged filter can have every particle in the same spot
+    return difference > 0 ? static_cast<float>(mod) / difference : 0;
+  }
+
+  static size_t hash(uint64_t key) {
+    return static_cast<size_t>((key * 0x9e3779b97f4a7c15ull) >> 32);
+  }
+
+  // moves the first copy of every distinct particle to the front
+  void removeDuplicates() {
+    std::memset(table, 0, sizeof(table));
+    unique = 0;
+    for (size_t i = 0; i < N; i++) {
+      uint64_t key = static_cast<uint16_t>(this->x[i]) |
+                     static_cast<uint32_t>(static_cast<uint16_t>(this->y[i]))
+                         << 16 |
+                     static_cast<uint64_t>(
+                         static_cast<uint16_t>(this->weights[i]))
+                         << 32;
+      size_t slot = hash(key) & (table_size - 1);
+      while (true) {
+        uint32_t entry = table[slot];
+        if (entry == 0) {
+          // unique <= i, so nothing that is still needed gets overwritten
+          table[slot] = unique + 1;
+          this->x[unique] = this->x[i];
+          this->y[unique] = this->y[i];
+          this->weights[unique] = this->weights[i];
+          counts[unique] = 1;
+          unique++;
+          break;
+        }
+        uint32_t u = entry - 1;
+        if (this->x[u] == this->x[i] && this->y[u] == this->y[i] &&
+            this->weights[u] == this->weights[i]) {
+          counts[u]++;
+          break;
+        }
+        slot = (slot + 1) & (table_size - 1);
+      }
     }
+  }
+
+  static void deltaEncode(int16_t *data, size_t n) {
+    int16_t last = 0;
+    for (size_t i = 0; i < n; i++) {
+      int16_t curr = data[i];
+      data[i] = curr - last;
+      last = curr;
+    }
+  }
+
+public:
+  char getMagic2() override { return particleLoggerMagic; }
+
+  void addParticles(float *x, float *y, float *weights, const size_t len) {
+    // duplicates are found on the quantized values, copies that drifted apart
+    // by less than a step still count as the same particle
+    this->quantizeParticles(
+        x, y, weights, len,
+        [](float *data, int16_t *out, std::pair<float, float> bounds,
+           uint32_t mod) {
+          quantize_floats(data, out, N, bounds.first,
+                          quantizationScale(bounds.second - bounds.first, mod));
+        });
+
+    removeDuplicates();
+
+    deltaEncode(this->x, unique);
+    deltaEncode(this->y, unique);
+    deltaEncode(this->weights, unique);
+  }
+
+  /**
+   * @brief Distinct particles in the last generation
+   */
+  size_t uniqueParticles() const { return unique; }
+
+  size_t LogData(LogBuffer *buffer) override {
+    // total len
+    size_t misc_len = 0;
+
+    misc_len += buffer->put(this->getMagic1());
+    misc_len += buffer->put(getMagic2());
+
+    misc_len += buffer->put_varint(this->payload_size);
+
+    size_t data_len = 0;
+    data_len += this->writeBounds(buffer);
+    data_len += buffer->put_varint(static_cast<uint32_t>(N));
+    data_len += buffer->put_varint(static_cast<uint32_t>(unique));
+
+    data_len += buffer->put_varint_array(this->x, unique);
+    data_len += buffer->put_varint_array(this->y, unique);
+    data_len += buffer->put_varint_array(this->weights, unique);
+    data_len += buffer->put_varint_array(counts, unique);
+
+    return misc_len + data_len;
+  }
+
+  static constexpr size_t max_size =
+      2 * sizeof(char) +  // magic
+      5 +                 // len
+      6 * sizeof(float) + // bounds
+      3 * 5 + 2 * 5 +     // mods, N and unique count
+      3 * N * 3 +         // particles
+      N * LogBuffer::max_varint_size<uint32_t>(); // counts
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override {
+    size_t counts_size = 0;
+    for (size_t i = 0; i < unique; i++)
+      counts_size += LogBuffer::varint_size(counts[i]);
+
+    this->payload_size =
+        this->boundsSize() + LogBuffer::varint_size(static_cast<uint32_t>(N)) +
+        LogBuffer::varint_size(static_cast<uint32_t>(unique)) +
+        LogBuffer::varint_array_size(this->x, unique) +
+        LogBuffer::varint_array_size(this->y, unique) +
+        LogBuffer::varint_array_size(this->weights, unique) + counts_size;
+    return 2 + LogBuffer::varint_size(this->payload_size) + this->payload_size;
+  }
+
+  ~DedupParticlesLogger() override = default;
+};
+
+// encodes each generation against the previous one. Positions live on a fixed
+// grid chosen at the last keyframe, so between keyframes a particle only costs
+// the (usually tiny) residual against the particle it was resampled from.
+//
+// [flags](N)(frames since keyframe)[weight bounds](weights mod)
+// keyframe: [x origin][y origin][step][x deltas][y deltas]
+// otherwise: (x shift)(y shift)(parent deltas, only with flag_parents)
+// [x residuals][y residuals]
+// [weight deltas]
+//
+// Both sides track positions in 1/subdivisions of a step. A keyframe sets
+// p[i] = subdivisions * v[i], where v are the delta coded whole steps.
+// Otherwise p[i] = prev[parent[i]] + shift + subdivisions * residual[i], and
+// the encoder picks the residual from the reconstructed prev, so quantization
+// error never builds up between keyframes. Positions are
+// origin + p[i] * step / subdivisions.
+//
+// Parents are written as differences between consecutive parent indices,
+// resampling usually emits them in order so most of them are 0 or 1
+template <size_t N> class TemporalParticlesLogger : public BaseTypeLogger {
+  static_assert(N <= (1 << 15), "parent deltas must fit in an int16");
+
+public:
+  static constexpr uint8_t flag_keyframe = 1 << 0;
+  static constexpr uint8_t flag_parents = 1 << 1;
+
+  static constexpr int subdivision_bits = 3;
+  static constexpr int subdivisions = 1 << subdivision_bits;
+
+  // 0.25 inch grid
+  static constexpr float position_step = 0.0254f / 4;
+  // half a step from the residuals plus half a subdivision from quantizing,
+  // before float rounding
+  static constexpr float max_position_error =
+      position_step / 2 + position_step / subdivisions / 2;
+
+private:
+  static constexpr char particleLoggerMagic = 0x4b;
+
+  // reconstructed positions of this and the previous generation in
+  // subdivisions, swapped every generation
+  int16_t positions_x[2][N];
+  int16_t positions_y[2][N];
+  int current = 0;
+
+  // what actually gets written
+  int16_t x[N];
+  int16_t y[N];
+  int16_t weights[N];
+  int16_t parent_deltas[N];
+
+  float x_origin = 0;
+  float y_origin = 0;
+  // common motion since the previous generation, in subdivisions
+  int16_t x_shift = 0;
+  int16_t y_shift = 0;
+  std::pair<float, float> weight_bounds;
+  uint32_t weights_mod;
+  // relative to the largest weight, same default as VarintParticlesLogger
+  float weight_error = 1.0f / (1 << 14);
+
+  uint8_t flags = 0;
+  uint32_t keyframe_interval;
+  uint32_t frames_since_keyframe = 0;
+  bool need_keyframe = true;
+
+  size_t payload_size = 0;
+
+  // nearest whole step of a position in subdivisions
+  static int32_t roundSteps(int32_t v) {
+    return (v + subdivisions / 2) >> subdivision_bits;
+  }
+
+  // rounded mean of cur[i] - prev[parent[i]]
+  static int16_t meanShift(const int16_t *cur, const int16_t *prev,
+                           const uint16_t *parents) {
+    int32_t sum = 0;
+    for (int i = 0; i < N; i++)
+      sum += cur[i] - prev[parents != nullptr ? parents[i] : i];
+    int32_t n = N;
+    return static_cast<int16_t>((sum + (sum >= 0 ? n / 2 : -n / 2)) / n);
+  }
+
+  // turns cur into the reconstruction the receiver will have
+  static void encodeResiduals(int16_t *cur, const int16_t *prev,
+                              const uint16_t *parents, int16_t shift,
+                              int16_t *residuals) {
     for (int i = 0; i < N; i++) {
-      data_len += buffer->write_varint(y[i]);
+      int32_t predicted = prev[parents != nullptr ? parents[i] : i] + shift;
+      int32_t r = roundSteps(cur[i] - predicted);
+      residuals[i] = static_cast<int16_t>(r);
+      cur[i] = static_cast<int16_t>(predicted + subdivisions * r);
     }
+  }
+
+  static void encodeKeyframe(int16_t *cur, int16_t *deltas) {
+    int16_t last = 0;
     for (int i = 0; i < N; i++) {
-      data_len += buffer->write_varint(weights[i]);
+      int16_t v = static_cast<int16_t>(roundSteps(cur[i]));
+      deltas[i] = v - last;
+      last = v;
+      cur[i] = static_cast<int16_t>(subdivisions * v);
+    }
+  }
+
+  size_t headerSize() {
+    size_t len = 1 + LogBuffer::varint_size(static_cast<uint32_t>(N)) +
+                 LogBuffer::varint_size(frames_since_keyframe) +
+                 2 * sizeof(float) + LogBuffer::varint_size(weights_mod);
+    if (flags & flag_keyframe)
+      len += 3 * sizeof(float);
+    else
+      len += LogBuffer::varint_size(x_shift) + LogBuffer::varint_size(y_shift);
+    return len;
+  }
+
+public:
+  /**
+   * @param keyframe_interval generations between keyframes, a receiver that
+   * missed a generation can only decode again after the next keyframe
+   */
+  TemporalParticlesLogger(uint32_t keyframe_interval = 50)
+      : keyframe_interval(keyframe_interval) {}
+
+  char getMagic2() override { return particleLoggerMagic; }
+
+  /**
+   * @brief Makes the next generation a keyframe
+   */
+  void forceKeyframe() { need_keyframe = true; }
+
+  /**
+   * @brief Sets the largest error of a weight after quantization, as a
+   * fraction of the largest weight of the generation. Positions are on a
+   * fixed grid, see max_position_error
+   */
+  void setMaxWeightError(float relative_weight) {
+    weight_error = relative_weight;
+  }
+
+  /**
+   * @param parents index in the previous generation each particle was
+   * resampled from, nullptr if the particles kept their order
+   */
+  void addParticles(float *x, float *y, float *weights, const size_t len,
+                    const uint16_t *parents = nullptr) {
+    // residuals need every particle
+    assert((len == N) && "must give the same amount of particles");
+
+    const int16_t *prev_x = positions_x[current];
+    const int16_t *prev_y = positions_y[current];
+    current ^= 1;
+    int16_t *cur_x = positions_x[current];
+    int16_t *cur_y = positions_y[current];
+
+    if (keyframe_interval != 0 &&
+        frames_since_keyframe + 1 >= keyframe_interval)
+      need_keyframe = true;
+
+    if (need_keyframe) {
+      std::pair<float, float> bounds[2];
+      float_bounds({x, y}, N, bounds);
+      x_origin = bounds[0].first;
+      y_origin = bounds[1].first;
+      flags = flag_keyframe;
+      frames_since_keyframe = 0;
+      need_keyframe = false;
+    } else {
+      flags = parents != nullptr ? flag_parents : 0;
+      frames_since_keyframe++;
+    }
+
+    const float scale = subdivisions / position_step;
+    quantize_floats(x, cur_x, N, x_origin, scale);
+    quantize_floats(y, cur_y, N, y_origin, scale);
+
+    if (flags & flag_keyframe) {
+      encodeKeyframe(cur_x, this->x);
+      encodeKeyframe(cur_y, this->y);
+    } else {
+      if (parents != nullptr) {
+        uint16_t last = 0;
+        for (int i = 0; i < N; i++) {
+          assert((parents[i] < N) && "parent index out of range");
+          parent_deltas[i] = parents[i] - last;
+          last = parents[i];
+        }
+      }
+
+      // every particle moved by roughly the same odometry step, removing it
+      // leaves mostly zeros for the compressor
+      x_shift = meanShift(cur_x, prev_x, parents);
+      y_shift = meanShift(cur_y, prev_y, parents);
+      encodeResiduals(cur_x, prev_x, parents, x_shift, this->x);
+      encodeResiduals(cur_y, prev_y, parents, y_shift, this->y);
+    }
+
+    // weights are recomputed every generation, nothing to gain from the
+    // previous one
+    weight_bounds = float_bounds(weights, N);
+    float largest_weight =
+        std::max(std::abs(weight_bounds.first), std::abs(weight_bounds.second));
+    weights_mod = error_bounded_mod(weight_bounds.first, weight_bounds.second,
+                                    weight_error * largest_weight);
+    compress_floats(weights, this->weights, N, weight_bounds.first,
+                    weight_bounds.second, weights_mod);
+  }
+
+  size_t LogData(LogBuffer *buffer) override {
+    // total len
+    size_t misc_len = 0;
+
+    misc_len += buffer->put(getMagic1());
+    misc_len += buffer->put(getMagic2());
+
+    misc_len += buffer->put_varint(payload_size);
+
+    size_t data_len = 0;
+    data_len += buffer->put(flags);
+    data_len += buffer->put_varint(static_cast<uint32_t>(N));
+    data_len += buffer->put_varint(frames_since_keyframe);
+    data_len += buffer->put(weight_bounds.first);
+    data_len += buffer->put(weight_bounds.second);
+    data_len += buffer->put_varint(weights_mod);
+
+    if (flags & flag_keyframe) {
+      data_len += buffer->put(x_origin);
+      data_len += buffer->put(y_origin);
+      data_len += buffer->put(position_step);
+    } else {
+      data_len += buffer->put_varint(x_shift);
+      data_len += buffer->put_varint(y_shift);
     }
+    if (flags & flag_parents)
+      data_len += buffer->put_varint_array(parent_deltas, N);
 
-    buffer->write_index(data_len_ind, data_len);
+    data_len += buffer->put_varint_array(x, N);
+    data_len += buffer->put_varint_array(y, N);
+    data_len += buffer->put_varint_array(weights, N);
 
     return misc_len + data_len;
   }
 
-  // at most three bytes per particle
-  size_t maxSize() override {
-    return 2 * sizeof(char) +     // magic
-           1 * sizeof(uint32_t) + // len
-           6 * sizeof(float) +    // bounds
-           3 * N * 3;             // particles
+  static constexpr size_t max_size = 2 * sizeof(char) +  // magic
+                                     5 +                 // len
+                                     1 + 5 + 5 +         // flags, N, frames
+                                     5 * sizeof(float) + // bounds and grid
+                                     5 + 2 * 3 +         // mod and shifts
+                                     4 * N * 3;          // particles, parents
+  size_t maxSize() override { return max_size; }
+
+  size_t encodedSize() override {
+    payload_size = headerSize() + LogBuffer::varint_array_size(x, N) +
+                   LogBuffer::varint_array_size(y, N) +
+                   LogBuffer::varint_array_size(weights, N);
+    if (flags & flag_parents)
+      payload_size += LogBuffer::varint_array_size(parent_deltas, N);
+    return 2 + LogBuffer::varint_size(payload_size) + payload_size;
   }
 
-  ~VarintParticlesLogger() override = default;
+  ~TemporalParticlesLogger() override = default;
 };
 
 // TODO: make it possible to dynamically add/remove distance sensors
 // should not be too hard to implement
 class GenerationInfoLogger : public CategoryLogger {
-private:
+public:
   static constexpr char generationInfoMagic = 0x40;
 
+private:
   std::vector<BaseMessageLogger *> children{
       &timestamp, &time_taken, &prediction, &distance1,
       &distance2, &distance3,  &distance4};
@@ -295,7 +958,9 @@ public:
     this->prediction.setData(px, py, pz);
   }
 
-  std::vector<BaseMessageLogger *> getChildren() override { return children; };
+  const std::vector<BaseMessageLogger *> &getChildren() override {
+    return children;
+  };
 
   size_t maxSize() override {
     size_t len = 0;
@@ -310,19 +975,29 @@ public:
 
 /**
  * @brief Holds all the information being printed by the PF
+ *
+ * @tparam ParticlesLogger encoding used for the particles, e.g.
+ * VarintParticlesLogger, StreamVByteParticlesLogger, BitPackedParticlesLogger,
+ * RansParticlesLogger, DedupParticlesLogger or TemporalParticlesLogger
  */
-template <size_t N> class PFLogger : public CategoryLogger {
+template <size_t N,
+          template <size_t> class ParticlesLogger = VarintParticlesLogger>
+class PFLogger : public CategoryLogger {
+public:
+  static constexpr char PFMagic = 0xaf;
+
 private:
   std::vector<BaseMessageLogger *> children{&generation_info, &particles};
-  static constexpr char PFMagic = 0xaf;
 
 public:
   GenerationInfoLogger generation_info;
-  VarintParticlesLogger<N> particles;
+  ParticlesLogger<N> particles;
 
   char getMagic2() override { return PFMagic; }
 
-  std::vector<BaseMessageLogger *> getChildren() override { return children; }
+  const std::vector<BaseMessageLogger *> &getChildren() override {
+    return children;
+  }
 
   size_t maxSize() override {
     size_t len = 0;
@@ -334,5 +1009,51 @@ public:
 
   ~PFLogger() override = default;
 };
+// compile time versions of the messages above, they produce the same bytes
+// without any virtual dispatch (see schema.hpp)
+
+class DistanceSensorMessage
+    : public schema::Message<DistanceSensorLogger::distanceInfoMagic,
+                             UIntLogger, FloatLogger, UIntLogger, UIntLogger,
+                             BoolLogger> {
+public:
+  void setData(int identifier, float measured_distance, int confidence,
+               int object_size, int exit) {
+    get<0>().setData(identifier);
+    get<1>().setData(measured_distance);
+    get<2>().setData(confidence);
+    get<3>().setData(object_size);
+    get<4>().setData(exit);
+  }
+};
+
+class GenerationInfoMessage
+    : public schema::Message<GenerationInfoLogger::generationInfoMagic,
+                             UIntLogger, UIntLogger, PoseLogger,
+                             DistanceSensorMessage, DistanceSensorMessage,
+                             DistanceSensorMessage, DistanceSensorMessage> {
+public:
+  void setData(int timestamp, int time_taken, float px, float py, float pz) {
+    get<0>().setData(timestamp);
+    get<1>().setData(time_taken);
+    get<2>().setData(px, py, pz);
+  }
+
+  DistanceSensorMessage &distance1() { return get<3>(); }
+  DistanceSensorMessage &distance2() { return get<4>(); }
+  DistanceSensorMessage &distance3() { return get<5>(); }
+  DistanceSensorMessage &distance4() { return get<6>(); }
+};
+
+template <size_t N,
+          template <size_t> class ParticlesLogger = VarintParticlesLogger>
+class PFMessage
+    : public schema::Message<PFLogger<N, ParticlesLogger>::PFMagic,
+                             GenerationInfoMessage, ParticlesLogger<N>> {
+public:
+  GenerationInfoMessage &generation_info() { return this->template get<0>(); }
+  ParticlesLogger<N> &particles() { return this->template get<1>(); }
+};
+
 } // namespace logger
 } // namespace vexmaps
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @brief Small shim over the few PROS calls the serializer needs, so it can
+ * also be built on a workstation (define VEXLOG_HOST)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef VEXLOG_HOST
+#include <chrono>
+#include <condition_variable>
+#include <fcntl.h>
+#include <mutex>
+#include <thread>
+#else
+#include "pros/apix.h"
+#endif
+
+namespace vexmaps {
+namespace logger {
+namespace platform {
+
+// timeout of BinarySemaphore::wait that never runs out
+constexpr uint32_t wait_forever = UINT32_MAX;
+
+#ifdef VEXLOG_HOST
+// replaces the steady clock when set, see setClock
+inline uint64_t (*simulated_clock)() = nullptr;
+
+/**
+ * @brief Makes micros() return clock() instead, e.g. to simulate a slow link
+ * without waiting for it. nullptr goes back to the real clock
+ */
+inline void setClock(uint64_t (*clock)()) { simulated_clock = clock; }
+
+inline uint64_t micros() {
+  if (simulated_clock != nullptr)
+    return simulated_clock();
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+inline void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * @brief Makes write(2) on fd return instead of waiting for room
+ */
+inline bool setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Background task, a std::thread on the host
+ */
+class Task {
+private:
+  std::thread thread;
+
+public:
+  Task(void (*function)(void *), void *arg, const char *name)
+      : thread(function, arg) {}
+
+  void join() { thread.join(); }
+};
+
+/**
+ * @brief Wakes a waiting task, posts while it is already posted are merged
+ */
+class BinarySemaphore {
+private:
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool posted = false;
+
+public:
+  void post() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      posted = true;
+    }
+    condition.notify_one();
+  }
+
+  /**
+   * @return false if timeout_ms passed without a post
+   */
+  bool wait(uint32_t timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (timeout_ms == wait_forever)
+      condition.wait(lock, [this] { return posted; });
+    else if (!condition.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                 [this] { return posted; }))
+      return false;
+    posted = false;
+    return true;
+  }
+};
+#else
+inline uint64_t micros() { return pros::c::micros(); }
+
+inline void delay(uint32_t ms) { pros::c::delay(ms); }
+
+inline bool setNonBlocking(int fd) {
+  return pros::c::fdctl(fd, SERCTL_NOBLKWRITE, nullptr) != PROS_ERR;
+}
+
+/**
+ * @brief Background task, a pros task one priority below the default so it
+ * never preempts the control loop
+ */
+class Task {
+private:
+  pros::task_t task;
+
+public:
+  Task(void (*function)(void *), void *arg, const char *name)
+      : task(pros::c::task_create(function, arg, TASK_PRIORITY_DEFAULT - 1,
+                                  TASK_STACK_DEPTH_DEFAULT, name)) {}
+
+  void join() { pros::c::task_join(task); }
+};
+
+/**
+ * @brief Wakes a waiting task, posts while it is already posted are merged
+ */
+class BinarySemaphore {
+private:
+  pros::c::sem_t sem = pros::c::sem_create(1, 0);
+
+public:
+  BinarySemaphore() = default;
+  BinarySemaphore(const BinarySemaphore &) = delete;
+  BinarySemaphore &operator=(const BinarySemaphore &) = delete;
+
+  ~BinarySemaphore() { pros::c::sem_delete(sem); }
+
+  void post() { pros::c::sem_post(sem); }
+
+  /**
+   * @return false if timeout_ms passed without a post
+   */
+  bool wait(uint32_t timeout_ms) {
+    return pros::c::sem_wait(
+        sem, timeout_ms == wait_forever ? TIMEOUT_MAX : timeout_ms);
+  }
+};
+#endif
+
+} // namespace platform
+} // namespace logger
+} // namespace vexmaps
@@ -0,0 +1,360 @@
+/**
+ * @file
+ * @brief Static rANS entropy coder for 16 bit particle deltas
+ *
+ * Values are zigzag encoded and turned into tokens: values below 16 are their
+ * own token, larger ones become 11 + their bit width, followed by the bits
+ * below the leading one as raw extra bits. Tokens are coded with a rANS that
+ * renormalizes 16 bits at a time, using a frequency table (scaled to
+ * 1 << scale_bits) sent with the data:
+ *
+ * (token count)(frequencies)(rans size)[rans bytes](extra size)[extra bits]
+ *
+ * Value i uses state i % 4 of four interleaved 32 bit rANS states, stored
+ * little endian at the start of the rans bytes, followed by little endian
+ * 16 bit words. Extra bits are packed LSB first in value order.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vexmaps {
+namespace logger {
+namespace rans {
+
+constexpr int scale_bits = 11;
+constexpr uint32_t scale = 1 << scale_bits;
+
+// values below this are coded directly
+constexpr uint32_t direct_tokens = 16;
+// plus one token per bit width from 5 to 16
+constexpr uint32_t token_count = direct_tokens + 12;
+
+// interleaved states, enough to hide the latency of a decoding step
+constexpr size_t state_count = 4;
+
+// lower bound of the normalized state. States stay below 1 << 31, which the
+// reciprocals of the encoder need, and a decoding step never takes more than
+// one word
+constexpr uint32_t state_low = 1 << 15;
+
+/**
+ * @brief Upper bound of the encoded size of n values
+ */
+constexpr size_t max_size(size_t n) {
+  return 1 +                                  // token count
+         token_count * 2 +                    // frequencies
+         2 * 5 +                              // rans and extra sizes
+         state_count * 4 +                    // states
+         (n * scale_bits + 15) / 16 * 2 + 8 + // rans words
+         (n * 15 + 7) / 8 + 8;                // extra bits
+}
+
+namespace detail {
+
+inline uint16_t zigzag(int16_t v) {
+  return static_cast<uint16_t>((static_cast<uint16_t>(v) << 1) ^ (v >> 15));
+}
+
+inline int16_t unzigzag(uint16_t v) {
+  return static_cast<int16_t>((v >> 1) ^ -(v & 1));
+}
+
+inline uint8_t token(uint16_t v) {
+  if (v < direct_tokens)
+    return v;
+  return static_cast<uint8_t>(11 + std::bit_width(v));
+}
+
+// number of raw bits after a token
+constexpr int extraBits(uint8_t token) {
+  return token < direct_tokens ? 0 : token - 12;
+}
+
+inline uint8_t *writeVarint(uint8_t *out, uint32_t v) {
+  while (v >= 128) {
+    *out++ = static_cast<uint8_t>(v | 128);
+    v >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(v);
+  return out;
+}
+
+inline const uint8_t *readVarint(const uint8_t *in, uint32_t &v) {
+  v = 0;
+  for (int shift = 0;; shift += 7) {
+    uint8_t byte = *in++;
+    v |= static_cast<uint32_t>(byte & 127) << shift;
+    if (!(byte & 128))
+      return in;
+  }
+}
+
+// scales counts so they sum to scale, every used token keeps at least 1
+inline void normalize(const uint32_t *counts, size_t n, uint32_t *freqs) {
+  uint32_t sum = 0;
+  uint32_t largest = 0;
+  for (uint32_t s = 0; s < token_count; s++) {
+    freqs[s] = counts[s] == 0
+                   ? 0
+                   : std::max<uint32_t>(
+                         1, static_cast<uint64_t>(counts[s]) * scale / n);
+    sum += freqs[s];
+    if (freqs[s] > freqs[largest])
+      largest = s;
+  }
+  // rounding error goes to the most common token, which can always absorb it
+  freqs[largest] += scale - sum;
+}
+
+// division free encoding (see ryg_rans), the cortex-a9 has no divide
+// instruction
+struct EncSymbol {
+  uint32_t x_max;
+  uint32_t rcp_freq;
+  uint32_t bias;
+  uint16_t cmpl_freq;
+  uint16_t rcp_shift;
+};
+
+inline EncSymbol encSymbol(uint32_t start, uint32_t freq) {
+  EncSymbol s;
+  s.x_max = ((state_low >> scale_bits) << 16) * freq;
+  s.cmpl_freq = static_cast<uint16_t>(scale - freq);
+  if (freq < 2) {
+    s.rcp_freq = ~0u;
+    s.rcp_shift = 0;
+    s.bias = start + scale - 1;
+  } else {
+    uint32_t shift = 0;
+    while (freq > (1u << shift))
+      shift++;
+    s.rcp_freq = static_cast<uint32_t>(((1ull << (shift + 31)) + freq - 1) /
+                                       freq);
+    s.rcp_shift = shift - 1;
+    s.bias = start;
+  }
+  return s;
+}
+
+} // namespace detail
+
+/**
+ * @brief Encodes n int16 values, returns the number of bytes written
+ *
+ * @param out needs max_size(n) bytes of room
+ * @param tokens scratch space for n tokens
+ */
+inline size_t encode(const int16_t *in, size_t n, uint8_t *out,
+                     uint8_t *tokens) {
+  uint32_t counts[token_count] = {};
+
+  // tokens and extra bits in value order
+  uint8_t *extra = out + max_size(n) - (n * 15 + 7) / 8 - 8;
+  uint8_t *extra_start = extra;
+  uint64_t bit_buffer = 0;
+  int bit_count = 0;
+  for (size_t i = 0; i < n; i++) {
+    uint16_t v = detail::zigzag(in[i]);
+    uint8_t t = detail::token(v);
+    tokens[i] = t;
+    counts[t]++;
+
+    int bits = detail::extraBits(t);
+    bit_buffer |= static_cast<uint64_t>(v & ((1u << bits) - 1)) << bit_count;
+    bit_count += bits;
+    while (bit_count >= 8) {
+      *extra++ = static_cast<uint8_t>(bit_buffer);
+      bit_buffer >>= 8;
+      bit_count -= 8;
+    }
+  }
+  if (bit_count > 0)
+    *extra++ = static_cast<uint8_t>(bit_buffer);
+  size_t extra_size = extra - extra_start;
+
+  uint32_t freqs[token_count] = {};
+  uint32_t used = 0;
+  if (n > 0) {
+    detail::normalize(counts, n, freqs);
+    for (uint32_t s = 0; s < token_count; s++)
+      if (freqs[s] != 0)
+        used = s + 1;
+  }
+
+  detail::EncSymbol symbols[token_count];
+  uint32_t start = 0;
+  for (uint32_t s = 0; s < used; s++) {
+    symbols[s] = detail::encSymbol(start, freqs[s]);
+    start += freqs[s];
+  }
+
+  // rans runs backwards, so the words are written backwards right before the
+  // extra bits. Consecutive values use separate states, which lets the CPU
+  // work on several values at once
+  uint8_t *ptr = extra_start;
+  uint32_t states[state_count];
+  std::fill(states, states + state_count, state_low);
+  for (size_t i = n; i-- > 0;) {
+    const detail::EncSymbol &s = symbols[tokens[i]];
+    uint32_t &x = states[i % state_count];
+    while (x >= s.x_max) {
+      ptr -= 2;
+      ptr[0] = static_cast<uint8_t>(x);
+      ptr[1] = static_cast<uint8_t>(x >> 8);
+      x >>= 16;
+    }
+    uint32_t q = static_cast<uint32_t>(
+                     (static_cast<uint64_t>(x) * s.rcp_freq) >> 32) >>
+                 s.rcp_shift;
+    x += s.bias + q * s.cmpl_freq;
+  }
+  ptr -= sizeof(states);
+  for (size_t k = 0; k < state_count; k++)
+    for (size_t b = 0; b < 4; b++)
+      ptr[k * 4 + b] = static_cast<uint8_t>(states[k] >> (8 * b));
+  size_t rans_size = extra_start - ptr;
+
+  uint8_t *header = out;
+  header = detail::writeVarint(header, used);
+  for (uint32_t s = 0; s < used; s++)
+    header = detail::writeVarint(header, freqs[s]);
+  header = detail::writeVarint(header, rans_size);
+  std::memmove(header, ptr, rans_size);
+  header += rans_size;
+  header = detail::writeVarint(header, extra_size);
+  std::memmove(header, extra_start, extra_size);
+  header += extra_size;
+
+  return header - out;
+}
+
+/**
+ * @brief Decodes n int16 values, returns the number of bytes consumed
+ */
+inline size_t decode(const uint8_t *in, size_t n, int16_t *out) {
+  const uint8_t *p = in;
+  uint32_t used;
+  p = detail::readVarint(p, used);
+  used = std::min(used, token_count);
+
+  // lookups per value: frequency, offset of the slot within the token's range
+  // and the token. Only slots past the frequencies (corrupt input) need
+  // clearing
+  std::array<uint16_t, scale> freqs;
+  std::array<uint16_t, scale> offsets;
+  std::array<uint8_t, scale> symbols;
+  uint32_t start = 0;
+  for (uint32_t s = 0; s < used; s++) {
+    uint32_t freq;
+    p = detail::readVarint(p, freq);
+    freq = std::min(freq, scale - start);
+    uint16_t *slot_freqs = freqs.data() + start;
+    uint16_t *slot_offsets = offsets.data() + start;
+    for (uint32_t i = 0; i < freq; i++) {
+      slot_freqs[i] = freq;
+      slot_offsets[i] = i;
+    }
+    std::fill_n(symbols.begin() + start, freq, s);
+    start += freq;
+  }
+  std::fill(freqs.begin() + start, freqs.end(), 0);
+  std::fill(offsets.begin() + start, offsets.end(), 0);
+  std::fill(symbols.begin() + start, symbols.end(), 0);
+
+  uint32_t rans_size;
+  p = detail::readVarint(p, rans_size);
+  const uint8_t *ptr = p;
+  const uint8_t *rans_end = p + rans_size;
+  uint32_t extra_size;
+  const uint8_t *extra_start = detail::readVarint(rans_end, extra_size);
+
+  uint32_t states[state_count];
+  for (size_t k = 0; k < state_count; k++, ptr += 4)
+    states[k] = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) |
+                (static_cast<uint32_t>(ptr[3]) << 24);
+
+  // value of a token: base | (extra bits & mask)
+  struct Token {
+    uint16_t base;
+    uint16_t mask;
+    uint32_t bits;
+  };
+  static constexpr auto tokens = [] {
+    std::array<Token, 32> tokens{};
+    for (uint32_t t = 0; t < token_count; t++) {
+      uint32_t bits = detail::extraBits(t);
+      tokens[t] = {static_cast<uint16_t>(t < direct_tokens ? t : 1u << bits),
+                   static_cast<uint16_t>((1u << bits) - 1), bits};
+    }
+    return tokens;
+  }();
+
+  // the next word is always read, so the only branch on the data is whether
+  // a state takes it. That one stays a branch: it is taken for about one
+  // value in six, and with a select every step waits on the word reads of
+  // the steps before it through ptr, which is about twice as slow
+  auto step = [&](uint32_t &x, bool checked) -> const Token & {
+    uint32_t slot = x & (scale - 1);
+    x = freqs[slot] * (x >> scale_bits) + offsets[slot];
+    uint16_t word = 0;
+    if (!checked || ptr + 2 <= rans_end)
+      std::memcpy(&word, ptr, 2);
+    if constexpr (std::endian::native == std::endian::big)
+      word = std::byteswap(word);
+    if (x < state_low) {
+      x = (x << 16) | word;
+      ptr += 2;
+    }
+    return tokens[symbols[slot]];
+  };
+  // unchecked rounds read the extra bits of each pair of values with one
+  // 8 byte read, which holds the up to 2 * 15 bits past the bit position.
+  // A round takes at most 2 bytes of words per state and 16 bytes of extra
+  // bits; once a round could run past either the reads are checked
+  size_t position = 0;
+  size_t i = 0;
+  for (; i + state_count <= n && rans_end - ptr >= 2 * state_count &&
+         position / 8 + 16 <= extra_size;
+       i += state_count) {
+    for (size_t k = 0; k < state_count; k += 2) {
+      uint64_t window;
+      std::memcpy(&window, extra_start + position / 8, 8);
+      if constexpr (std::endian::native == std::endian::big)
+        window = std::byteswap(window);
+      window >>= position % 8;
+      for (size_t j = k; j < k + 2; j++) {
+        const Token &t = step(states[j], false);
+        out[i + j] = detail::unzigzag(t.base | (window & t.mask));
+        window >>= t.bits;
+        position += t.bits;
+      }
+    }
+  }
+  for (; i < n; i++) {
+    const Token &t = step(states[i % state_count], true);
+    uint64_t window = 0;
+    if (position / 8 + 8 <= extra_size) {
+      std::memcpy(&window, extra_start + position / 8, 8);
+      if constexpr (std::endian::native == std::endian::big)
+        window = std::byteswap(window);
+    } else {
+      for (size_t b = position / 8, shift = 0; b < extra_size; b++, shift += 8)
+        window |= static_cast<uint64_t>(extra_start[b]) << shift;
+    }
+    out[i] = detail::unzigzag(t.base | ((window >> position % 8) & t.mask));
+    position += t.bits;
+  }
+
+  return extra_start - in + extra_size;
+}
+
+} // namespace rans
+} // namespace logger
+} // namespace vexmaps
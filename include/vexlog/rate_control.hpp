@@ -0,0 +1,336 @@
+/**
+ * @file
+ * @brief Keeps the telemetry link under a bytes per second budget by sending
+ * less detailed frames when it runs out of room
+ *
+ * A token bucket fills at the budget (or at the rate of the link, when that
+ * is lower) up to a burst size, and every sent frame takes its size out of
+ * it. The link rate is given up front and lowered to the throughput writes
+ * actually achieved when they had to wait for the link. Time a write spent
+ * blocked earns no tokens, so a link that cannot keep up quickly pushes the
+ * controller to smaller frames.
+ *
+ * Before a frame is built its compressed size is estimated from its raw size
+ * and the compression ratio of earlier frames of the same detail, and the
+ * most detailed frame that fits is sent. A share of every refill is saved for
+ * full frames, which less detailed frames may not spend. Without it the small
+ * frames take the tokens as soon as they come in and the bucket never fills
+ * up to a full frame. Estimates can be off, so the bucket
+ * is allowed to go into debt, which later frames pay back before anything
+ * else is sent. Over any window of T seconds the link carries at most
+ * burst + T * rate bytes plus the underestimate of the last frame sent in it
+ * (see largestUnderestimate).
+ */
+
+#pragma once
+
+#include "logger.hpp"
+#include "pf_logger.hpp"
+#include "platform.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace vexmaps {
+namespace logger {
+
+enum class FrameDetail {
+  // every particle
+  Full,
+  // every few particles
+  Decimated,
+  // only the GenerationInfoLogger
+  InfoOnly,
+  // nothing fits right now
+  Skip
+};
+
+class RateController {
+private:
+  // bytes per second
+  float budget;
+  float link_rate;
+  float burst;
+  // starts empty, so the long run average never goes above the rate
+  float tokens = 0;
+  // part of tokens only full frames may spend
+  float saved = 0;
+  float full_share;
+  uint64_t last_refill = 0;
+  bool started = false;
+
+  // bytes per second the link managed while a write blocked, negative until
+  // measured
+  float throughput = -1;
+
+  // running average of sent / raw size per detail, starts pessimistic
+  float ratios[3] = {1.1f, 1.1f, 1.1f};
+
+  // size the last fits() call expected, to compare with what was sent
+  float last_estimate = 0;
+  float underestimate = 0;
+
+  // writes shorter than this did not wait on the link, so they say nothing
+  // about its throughput
+  static constexpr uint64_t min_blocked_micros = 1000;
+
+  void refill(uint64_t now) {
+    if (!started) {
+      last_refill = now;
+      started = true;
+    }
+    float elapsed = (now - last_refill) * 1e-6f;
+    last_refill = now;
+    float earned = elapsed * rate();
+    tokens = std::min(burst, tokens + earned);
+    saved = std::min(tokens, saved + earned * full_share);
+  }
+
+public:
+  /**
+   * @param budget bytes per second the link may carry
+   * @param burst bytes that may be sent at once after an idle period, at least
+   * the largest frame
+   * @param link_rate bytes per second the link can carry at most (e.g. 11520
+   * for 115200 baud), 0 if unknown
+   * @param full_share fraction of the rate saved for full frames
+   */
+  RateController(uint32_t budget, uint32_t burst, uint32_t link_rate = 0,
+                 float full_share = 0.5f)
+      : budget(budget), link_rate(link_rate), burst(burst),
+        full_share(full_share) {
+    assert((full_share >= 0 && full_share <= 1) && "share must be a fraction");
+  }
+
+  void setBudget(uint32_t budget) { this->budget = budget; }
+  uint32_t getBudget() const { return budget; }
+
+  /**
+   * @brief Bytes per second the bucket refills at
+   */
+  float rate() const {
+    float rate = budget;
+    if (link_rate > 0)
+      rate = std::min(rate, link_rate);
+    if (throughput > 0)
+      rate = std::min(rate, throughput);
+    return rate;
+  }
+
+  /**
+   * @brief Whether a frame of raw_size serialized bytes fits in the budget at
+   * time now (in microseconds)
+   */
+  bool fits(FrameDetail detail, size_t raw_size, uint64_t now) {
+    refill(now);
+    last_estimate = raw_size * ratios[static_cast<int>(detail)];
+    float available = detail == FrameDetail::Full ? tokens : tokens - saved;
+    return last_estimate <= available;
+  }
+
+  /**
+   * @brief Picks the most detailed frame that fits, raw sizes are what
+   * buildData() will produce
+   */
+  FrameDetail choose(size_t full_size, size_t decimated_size,
+                     size_t info_size, uint64_t now) {
+    if (fits(FrameDetail::Full, full_size, now))
+      return FrameDetail::Full;
+    if (fits(FrameDetail::Decimated, decimated_size, now))
+      return FrameDetail::Decimated;
+    if (fits(FrameDetail::InfoOnly, info_size, now))
+      return FrameDetail::InfoOnly;
+    return FrameDetail::Skip;
+  }
+
+  /**
+   * @brief Takes a sent frame out of the bucket, detail must be what the last
+   * fits() call that returned true was asked about
+   */
+  void record(FrameDetail detail, const SendStats &stats) {
+    if (detail == FrameDetail::Skip)
+      return;
+
+    tokens -= stats.sent_size;
+    underestimate = std::max(underestimate, stats.sent_size - last_estimate);
+    if (stats.raw_size > 0) {
+      float &ratio = ratios[static_cast<int>(detail)];
+      ratio += (static_cast<float>(stats.sent_size) / stats.raw_size - ratio) /
+               4;
+    }
+    if (stats.send_time >= min_blocked_micros) {
+      float sample = stats.sent_size * 1e6f / stats.send_time;
+      throughput =
+          throughput < 0 ? sample : throughput + (sample - throughput) / 8;
+      // the next refill counts the blocked time, which must not earn tokens
+      tokens -= stats.send_time * 1e-6f * rate();
+    }
+    // full frames spend the saved tokens first
+    if (detail == FrameDetail::Full)
+      saved -= stats.sent_size;
+    saved = std::clamp(saved, 0.0f, std::max(tokens, 0.0f));
+  }
+
+  /**
+   * @brief Bytes that can be sent right now, negative while in debt
+   */
+  float availableBytes() const { return tokens; }
+
+  /**
+   * @brief Part of availableBytes() that only full frames may spend
+   */
+  float savedBytes() const { return saved; }
+
+  /**
+   * @brief Measured link throughput in bytes per second, negative until a
+   * write had to wait for the link
+   */
+  float measuredThroughput() const { return throughput; }
+
+  /**
+   * @brief Most bytes a frame was larger than estimated, what the bucket can
+   * overshoot by
+   */
+  float largestUnderestimate() const { return underestimate; }
+};
+
+/**
+ * @brief PFLogger that sends fewer particles, or only the generation info,
+ * when the link is out of budget.
+ *
+ * Full frames are the same as PFLogger<N>. Decimated frames have magic
+ * PFDecimatedMagic and carry every N / M th particle:
+ *
+ * [info][particle count (UIntLogger)][particles]
+ *
+ * Info only frames are just the GenerationInfoLogger. Particle loggers that
+ * depend on the previous generation (TemporalParticlesLogger) are rejected,
+ * since any generation may be skipped.
+ */
+template <size_t N, size_t M,
+          template <size_t> class ParticlesLogger = VarintParticlesLogger>
+class RateLimitedPFLogger {
+  static_assert(M > 0 && M < N, "decimated frames need fewer particles");
+  static_assert(
+      !std::is_base_of_v<TemporalParticlesLogger<N>, ParticlesLogger<N>>,
+      "generations may be skipped, so particles cannot depend on the last one");
+
+public:
+  static constexpr char PFDecimatedMagic = 0xae;
+
+  GenerationInfoLogger generation_info;
+  ParticlesLogger<N> particles;
+
+private:
+  class Full : public CategoryLogger {
+  private:
+    std::vector<BaseMessageLogger *> children;
+
+  public:
+    Full(RateLimitedPFLogger &parent)
+        : children{&parent.generation_info, &parent.particles} {}
+
+    char getMagic2() override {
+      return PFLogger<N, ParticlesLogger>::PFMagic;
+    }
+
+    const std::vector<BaseMessageLogger *> &getChildren() override {
+      return children;
+    }
+
+    size_t maxSize() override {
+      size_t len = 0;
+      for (auto curr : children)
+        len += curr->maxSize();
+      return len;
+    }
+  };
+
+  class Decimated : public CategoryLogger {
+  private:
+    std::vector<BaseMessageLogger *> children;
+
+  public:
+    UIntLogger count{static_cast<uint32_t>(M)};
+    ParticlesLogger<M> particles;
+
+    Decimated(RateLimitedPFLogger &parent)
+        : children{&parent.generation_info, &count, &particles} {}
+
+    char getMagic2() override { return PFDecimatedMagic; }
+
+    const std::vector<BaseMessageLogger *> &getChildren() override {
+      return children;
+    }
+
+    size_t maxSize() override {
+      size_t len = 0;
+      for (auto curr : children)
+        len += curr->maxSize();
+      return len;
+    }
+  };
+
+  Full full{*this};
+  Decimated decimated{*this};
+
+  // every N / M th particle, only encoded when a decimated frame is sent
+  float decimated_x[M];
+  float decimated_y[M];
+  float decimated_weights[M];
+
+public:
+  RateLimitedPFLogger() = default;
+  RateLimitedPFLogger(const RateLimitedPFLogger &) = delete;
+  RateLimitedPFLogger &operator=(const RateLimitedPFLogger &) = delete;
+
+  void addParticles(float *x, float *y, float *weights, const size_t len) {
+    particles.addParticles(x, y, weights, len);
+    for (size_t i = 0; i < M; i++) {
+      size_t k = i * N / M;
+      decimated_x[i] = x[k];
+      decimated_y[i] = y[k];
+      decimated_weights[i] = weights[k];
+    }
+  }
+
+  /**
+   * @brief Sends the most detailed frame the budget allows, or nothing
+   *
+   * @return what was sent
+   */
+  FrameDetail send(LogSession &session, RateController &controller) {
+    uint64_t now = platform::micros();
+
+    // the sizes are kept so the session does not compute them again
+    FrameDetail detail = FrameDetail::Skip;
+    BaseMessageLogger *message = nullptr;
+    size_t size = full.encodedSize();
+    if (controller.fits(FrameDetail::Full, size, now)) {
+      detail = FrameDetail::Full;
+      message = &full;
+    } else {
+      decimated.particles.addParticles(decimated_x, decimated_y,
+                                       decimated_weights, M);
+      size = decimated.encodedSize();
+      if (controller.fits(FrameDetail::Decimated, size, now)) {
+        detail = FrameDetail::Decimated;
+        message = &decimated;
+      } else {
+        size = generation_info.encodedSize();
+        if (controller.fits(FrameDetail::InfoOnly, size, now)) {
+          detail = FrameDetail::InfoOnly;
+          message = &generation_info;
+        }
+      }
+    }
+
+    if (message != nullptr)
+      controller.record(detail, session.send(*message, size));
+    return detail;
+  }
+};
+
+} // namespace logger
+} // namespace vexmaps
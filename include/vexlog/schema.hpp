@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Compile time message schemas
+ *
+ * A schema::Message lists its fields as template arguments instead of
+ * building a tree of BaseMessageLogger pointers, so the whole encoder is
+ * resolved at compile time: no virtual calls, no children vectors and a
+ * constexpr max_size. It writes exactly the same bytes as the equivalent
+ * CategoryLogger tree.
+ *
+ * Fields can be the basic type loggers (IntLogger, PoseLogger, particle
+ * loggers, ...) or other Messages.
+ */
+
+#pragma once
+
+#include "logger.hpp"
+#include <tuple>
+
+namespace vexmaps {
+namespace logger {
+namespace schema {
+
+namespace detail {
+// qualified calls so the field loggers are never dispatched through their
+// vtables
+template <typename T> inline size_t encodedSize(T &field) {
+  return field.T::encodedSize();
+}
+
+template <typename T> inline size_t logData(T &field, LogBuffer *buffer) {
+  return field.T::LogData(buffer);
+}
+} // namespace detail
+
+/**
+ * @brief Category message with magic Magic made of Fields, in order
+ */
+template <char Magic, typename... Fields> class Message {
+private:
+  std::tuple<Fields...> fields;
+
+  // combined size of the fields, from the last encodedSize() call
+  size_t payload_size = 0;
+
+public:
+  static constexpr char magic = Magic;
+
+  static constexpr size_t max_size =
+      2 + LogBuffer::max_varint_size<uint32_t>() +
+      (Fields::max_size + ... + 0);
+
+  template <size_t I> auto &get() { return std::get<I>(fields); }
+
+  size_t encodedSize() {
+    payload_size = std::apply(
+        [](auto &...field) {
+          return (detail::encodedSize(field) + ... + size_t(0));
+        },
+        fields);
+    return 2 + LogBuffer::varint_size(payload_size) + payload_size;
+  }
+
+  // sizes must have been computed with encodedSize() first
+  size_t LogData(LogBuffer *buffer) {
+    size_t misc_len = 0;
+    misc_len += buffer->put(CategoryLogger::basicDataTypeMagic);
+    misc_len += buffer->put(Magic);
+    misc_len += buffer->put_varint(payload_size);
+
+    std::apply(
+        [buffer](auto &...field) { (detail::logData(field, buffer), ...); },
+        fields);
+
+    return misc_len + payload_size;
+  }
+
+  /**
+   * @brief Serializes the message, equivalent of logger::buildData
+   */
+  size_t build(LogBuffer *buffer) {
+    [[maybe_unused]] size_t size = encodedSize();
+    // the whole message is checked against the buffer once
+    buffer->reserve(max_size);
+    size_t written = LogData(buffer);
+    assert((written == size) && "encodedSize does not match written size");
+    return written;
+  }
+};
+
+template <typename M> inline size_t buildData(M &message, LogBuffer *buffer) {
+  return message.build(buffer);
+}
+
+} // namespace schema
+} // namespace logger
+} // namespace vexmaps
@@ -0,0 +1,436 @@
+/**
+ * @file
+ * @brief Thin portable SIMD layer used by the encoding kernels
+ *
+ * Backends are picked at compile time:
+ * - NEON on the V5 brain (cortex-a9)
+ * - SSE4.1 (+F16C when available) on x86-64 hosts
+ * - plain scalar code everywhere else, or when VEXLOG_SIMD_SCALAR is defined
+ *
+ * Every backend must produce bit-identical results, so only operations with an
+ * exact scalar equivalent belong here (no fused multiply-add, no rounding
+ * modes, truncating narrows).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(VEXLOG_SIMD_SCALAR)
+#define VEXLOG_SIMD_BACKEND_SCALAR 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VEXLOG_SIMD_BACKEND_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE4_1__)
+#define VEXLOG_SIMD_BACKEND_SSE 1
+#include <immintrin.h>
+#else
+#define VEXLOG_SIMD_BACKEND_SCALAR 1
+#endif
+
+namespace vexmaps {
+namespace logger {
+
+#if !defined(VEXLOG_SIMD_BACKEND_NEON)
+// arm_neon.h normally provides this, use the compiler's IEEE half elsewhere
+using float16_t = _Float16;
+#endif
+
+namespace simd {
+
+#if defined(VEXLOG_SIMD_BACKEND_NEON)
+
+constexpr const char *backend_name = "neon";
+
+using f32x4 = float32x4_t;
+using s32x4 = int32x4_t;
+
+inline f32x4 load(const float *p) { return vld1q_f32(p); }
+inline f32x4 dup(float v) { return vdupq_n_f32(v); }
+
+// acc + a * b, not fused
+inline f32x4 mla(f32x4 acc, f32x4 a, f32x4 b) { return vmlaq_f32(acc, a, b); }
+
+inline f32x4 min(f32x4 a, f32x4 b) { return vminq_f32(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) { return vmaxq_f32(a, b); }
+
+// smallest and largest lane
+inline float hmin(f32x4 v) {
+  float32x2_t m = vpmin_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpmin_f32(m, m), 0);
+}
+inline float hmax(f32x4 v) {
+  float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpmax_f32(m, m), 0);
+}
+
+// truncates towards zero
+inline s32x4 cvt_s32(f32x4 v) { return vcvtq_s32_f32(v); }
+
+// nearest, halfway cases away from zero. vcvtnq needs armv8, so 0.5 with the
+// sign of v is added before truncating
+inline s32x4 round_s32(f32x4 v) {
+  f32x4 half = vbslq_f32(vdupq_n_u32(0x80000000), v, vdupq_n_f32(0.5f));
+  return vcvtq_s32_f32(vaddq_f32(v, half));
+}
+
+// keeps the low 16 bits of every lane
+inline void store_narrow_s16(int16_t *p, s32x4 v) { vst1_s16(p, vmovn_s32(v)); }
+
+inline void store_f16(float16_t *p, f32x4 v) { vst1_f16(p, vcvt_f16_f32(v)); }
+
+inline void store(float *p, f32x4 v) { vst1q_f32(p, v); }
+inline f32x4 cvt_f32(s32x4 v) { return vcvtq_f32_s32(v); }
+
+// 16 bit lanes, arithmetic wraps around
+using s16x8 = int16x8_t;
+
+inline s16x8 load_s16(const int16_t *p) { return vld1q_s16(p); }
+inline void store_s16(int16_t *p, s16x8 v) { vst1q_s16(p, v); }
+inline s16x8 zero_s16() { return vdupq_n_s16(0); }
+
+inline s16x8 add(s16x8 a, s16x8 b) { return vaddq_s16(a, b); }
+inline s16x8 sub(s16x8 a, s16x8 b) { return vsubq_s16(a, b); }
+
+// keeps the low 16 bits of every lane, lo becomes lanes 0-3
+inline s16x8 narrow_s16(s32x4 lo, s32x4 hi) {
+  return vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+}
+
+inline s32x4 widen_lo(s16x8 v) { return vmovl_s16(vget_low_s16(v)); }
+inline s32x4 widen_hi(s16x8 v) { return vmovl_s16(vget_high_s16(v)); }
+
+// {prev[7], v[0], ..., v[6]}, the lanes one element before v
+inline s16x8 prev_lanes(s16x8 prev, s16x8 v) { return vextq_s16(prev, v, 7); }
+
+// moves lanes up by K, filling with zeros
+template <int K> inline s16x8 shift_lanes(s16x8 v) {
+  return vextq_s16(vdupq_n_s16(0), v, 8 - K);
+}
+
+inline s16x8 dup_last(s16x8 v) { return vdupq_lane_s16(vget_high_s16(v), 3); }
+
+inline s16x8 dup_s16(int16_t v) { return vdupq_n_s16(v); }
+
+// 16 little endian lanes from bytes with any alignment
+inline s16x8 load_bytes(const uint8_t *p) {
+  return vreinterpretq_s16_u8(vld1q_u8(p));
+}
+inline void store_bytes(uint8_t *p, s16x8 v) {
+  vst1q_u8(p, vreinterpretq_u8_s16(v));
+}
+
+inline s16x8 min(s16x8 a, s16x8 b) { return vminq_s16(a, b); }
+inline s16x8 max(s16x8 a, s16x8 b) { return vmaxq_s16(a, b); }
+
+inline s16x8 bit_and(s16x8 a, s16x8 b) { return vandq_s16(a, b); }
+inline s16x8 bit_or(s16x8 a, s16x8 b) { return vorrq_s16(a, b); }
+
+// K from 1 to 15, right shifts are logical
+template <int K> inline s16x8 shl(s16x8 v) { return vshlq_n_s16(v, K); }
+template <int K> inline s16x8 shr(s16x8 v) {
+  return vreinterpretq_s16_u16(vshrq_n_u16(vreinterpretq_u16_s16(v), K));
+}
+
+#elif defined(VEXLOG_SIMD_BACKEND_SSE)
+
+constexpr const char *backend_name = "sse";
+
+using f32x4 = __m128;
+using s32x4 = __m128i;
+
+inline f32x4 load(const float *p) { return _mm_loadu_ps(p); }
+inline f32x4 dup(float v) { return _mm_set1_ps(v); }
+
+inline f32x4 mla(f32x4 acc, f32x4 a, f32x4 b) {
+  return _mm_add_ps(acc, _mm_mul_ps(a, b));
+}
+
+inline f32x4 min(f32x4 a, f32x4 b) { return _mm_min_ps(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a, b); }
+
+inline float hmin(f32x4 v) {
+  v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+  return _mm_cvtss_f32(_mm_min_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+inline float hmax(f32x4 v) {
+  v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+  return _mm_cvtss_f32(_mm_max_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+
+inline s32x4 cvt_s32(f32x4 v) { return _mm_cvttps_epi32(v); }
+
+// not _mm_cvtps_epi32, which rounds halfway cases to even unlike NEON
+inline s32x4 round_s32(f32x4 v) {
+  f32x4 half = _mm_or_ps(_mm_and_ps(v, _mm_set1_ps(-0.0f)), _mm_set1_ps(0.5f));
+  return _mm_cvttps_epi32(_mm_add_ps(v, half));
+}
+
+inline void store_narrow_s16(int16_t *p, s32x4 v) {
+  // masking first makes the unsigned saturating pack an exact truncation,
+  // matching vmovn
+  __m128i low = _mm_and_si128(v, _mm_set1_epi32(0xffff));
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_packus_epi32(low, low));
+}
+
+inline void store_f16(float16_t *p, f32x4 v) {
+#if defined(__F16C__)
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(p),
+                   _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#else
+  alignas(16) float tmp[4];
+  _mm_store_ps(tmp, v);
+  for (int i = 0; i < 4; i++)
+    p[i] = static_cast<float16_t>(tmp[i]);
+#endif
+}
+
+inline void store(float *p, f32x4 v) { _mm_storeu_ps(p, v); }
+inline f32x4 cvt_f32(s32x4 v) { return _mm_cvtepi32_ps(v); }
+
+using s16x8 = __m128i;
+
+inline s16x8 load_s16(const int16_t *p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+inline void store_s16(int16_t *p, s16x8 v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+}
+inline s16x8 zero_s16() { return _mm_setzero_si128(); }
+
+inline s16x8 add(s16x8 a, s16x8 b) { return _mm_add_epi16(a, b); }
+inline s16x8 sub(s16x8 a, s16x8 b) { return _mm_sub_epi16(a, b); }
+
+inline s16x8 narrow_s16(s32x4 lo, s32x4 hi) {
+  const __m128i mask = _mm_set1_epi32(0xffff);
+  return _mm_packus_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+}
+
+inline s32x4 widen_lo(s16x8 v) { return _mm_cvtepi16_epi32(v); }
+inline s32x4 widen_hi(s16x8 v) {
+  return _mm_cvtepi16_epi32(_mm_unpackhi_epi64(v, v));
+}
+
+inline s16x8 prev_lanes(s16x8 prev, s16x8 v) {
+  return _mm_alignr_epi8(v, prev, 14);
+}
+
+template <int K> inline s16x8 shift_lanes(s16x8 v) {
+  return _mm_slli_si128(v, 2 * K);
+}
+
+inline s16x8 dup_last(s16x8 v) {
+  return _mm_shuffle_epi32(_mm_shufflehi_epi16(v, 0xff), 0xff);
+}
+
+inline s16x8 dup_s16(int16_t v) { return _mm_set1_epi16(v); }
+
+inline s16x8 load_bytes(const uint8_t *p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+inline void store_bytes(uint8_t *p, s16x8 v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+}
+
+inline s16x8 min(s16x8 a, s16x8 b) { return _mm_min_epi16(a, b); }
+inline s16x8 max(s16x8 a, s16x8 b) { return _mm_max_epi16(a, b); }
+
+inline s16x8 bit_and(s16x8 a, s16x8 b) { return _mm_and_si128(a, b); }
+inline s16x8 bit_or(s16x8 a, s16x8 b) { return _mm_or_si128(a, b); }
+
+template <int K> inline s16x8 shl(s16x8 v) { return _mm_slli_epi16(v, K); }
+template <int K> inline s16x8 shr(s16x8 v) { return _mm_srli_epi16(v, K); }
+
+#else
+
+constexpr const char *backend_name = "scalar";
+
+struct f32x4 {
+  float v[4];
+};
+struct s32x4 {
+  int32_t v[4];
+};
+
+inline f32x4 load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline f32x4 dup(float v) { return {{v, v, v, v}}; }
+
+inline f32x4 mla(f32x4 acc, f32x4 a, f32x4 b) {
+  for (int i = 0; i < 4; i++) {
+    float product = a.v[i] * b.v[i];
+    acc.v[i] = acc.v[i] + product;
+  }
+  return acc;
+}
+
+inline f32x4 min(f32x4 a, f32x4 b) {
+  for (int i = 0; i < 4; i++)
+    a.v[i] = std::min(a.v[i], b.v[i]);
+  return a;
+}
+inline f32x4 max(f32x4 a, f32x4 b) {
+  for (int i = 0; i < 4; i++)
+    a.v[i] = std::max(a.v[i], b.v[i]);
+  return a;
+}
+
+inline float hmin(f32x4 v) {
+  return std::min(std::min(v.v[0], v.v[1]), std::min(v.v[2], v.v[3]));
+}
+inline float hmax(f32x4 v) {
+  return std::max(std::max(v.v[0], v.v[1]), std::max(v.v[2], v.v[3]));
+}
+
+inline s32x4 cvt_s32(f32x4 v) {
+  s32x4 r;
+  for (int i = 0; i < 4; i++)
+    r.v[i] = static_cast<int32_t>(v.v[i]);
+  return r;
+}
+
+inline s32x4 round_s32(f32x4 v) {
+  s32x4 r;
+  for (int i = 0; i < 4; i++)
+    r.v[i] = static_cast<int32_t>(v.v[i] + std::copysign(0.5f, v.v[i]));
+  return r;
+}
+
+inline void store_narrow_s16(int16_t *p, s32x4 v) {
+  for (int i = 0; i < 4; i++)
+    p[i] = static_cast<int16_t>(v.v[i]);
+}
+
+inline void store_f16(float16_t *p, f32x4 v) {
+  for (int i = 0; i < 4; i++)
+    p[i] = static_cast<float16_t>(v.v[i]);
+}
+
+inline void store(float *p, f32x4 v) {
+  for (int i = 0; i < 4; i++)
+    p[i] = v.v[i];
+}
+
+inline f32x4 cvt_f32(s32x4 v) {
+  f32x4 r;
+  for (int i = 0; i < 4; i++)
+    r.v[i] = static_cast<float>(v.v[i]);
+  return r;
+}
+
+struct s16x8 {
+  int16_t v[8];
+};
+
+inline s16x8 load_s16(const int16_t *p) {
+  s16x8 r;
+  for (int i = 0; i < 8; i++)
+    r.v[i] = p[i];
+  return r;
+}
+inline void store_s16(int16_t *p, s16x8 v) {
+  for (int i = 0; i < 8; i++)
+    p[i] = v.v[i];
+}
+inline s16x8 zero_s16() { return {}; }
+
+inline s16x8 add(s16x8 a, s16x8 b) {
+  for (int i = 0; i < 8; i++)
+    a.v[i] = static_cast<int16_t>(a.v[i] + b.v[i]);
+  return a;
+}
+inline s16x8 sub(s16x8 a, s16x8 b) {
+  for (int i = 0; i < 8; i++)
+    a.v[i] = static_cast<int16_t>(a.v[i] - b.v[i]);
+  return a;
+}
+
+inline s16x8 narrow_s16(s32x4 lo, s32x4 hi) {
+  s16x8 r;
+  for (int i = 0; i < 4; i++) {
+    r.v[i] = static_cast<int16_t>(lo.v[i]);
+    r.v[i + 4] = static_cast<int16_t>(hi.v[i]);
+  }
+  return r;
+}
+
+inline s32x4 widen_lo(s16x8 v) { return {{v.v[0], v.v[1], v.v[2], v.v[3]}}; }
+inline s32x4 widen_hi(s16x8 v) { return {{v.v[4], v.v[5], v.v[6], v.v[7]}}; }
+
+inline s16x8 prev_lanes(s16x8 prev, s16x8 v) {
+  s16x8 r;
+  r.v[0] = prev.v[7];
+  for (int i = 1; i < 8; i++)
+    r.v[i] = v.v[i - 1];
+  return r;
+}
+
+template <int K> inline s16x8 shift_lanes(s16x8 v) {
+  s16x8 r = {};
+  for (int i = K; i < 8; i++)
+    r.v[i] = v.v[i - K];
+  return r;
+}
+
+inline s16x8 dup_last(s16x8 v) {
+  s16x8 r;
+  for (int i = 0; i < 8; i++)
+    r.v[i] = v.v[7];
+  return r;
+}
+
+inline s16x8 dup_s16(int16_t v) { return {{v, v, v, v, v, v, v, v}}; }
+
+inline s16x8 load_bytes(const uint8_t *p) {
+  s16x8 r;
+  for (int i = 0; i < 8; i++)
+    r.v[i] = static_cast<int16_t>(p[2 * i] | (p[2 * i + 1] << 8));
+  return r;
+}
+inline void store_bytes(uint8_t *p, s16x8 v) {
+  for (int i = 0; i < 8; i++) {
+    p[2 * i] = static_cast<uint8_t>(v.v[i]);
+    p[2 * i + 1] = static_cast<uint8_t>(static_cast<uint16_t>(v.v[i]) >> 8);
+  }
+}
+
+inline s16x8 min(s16x8 a, s16x8 b) {
+  for (int i = 0; i < 8; i++)
+    a.v[i] = std::min(a.v[i], b.v[i]);
+  return a;
+}
+inline s16x8 max(s16x8 a, s16x8 b) {
+  for (int i = 0; i < 8; i++)
+    a.v[i] = std::max(a.v[i], b.v[i]);
+  return a;
+}
+
+inline s16x8 bit_and(s16x8 a, s16x8 b) {
+  for (int i = 0; i < 8; i++)
+    a.v[i] &= b.v[i];
+  return a;
+}
+inline s16x8 bit_or(s16x8 a, s16x8 b) {
+  for (int i = 0; i < 8; i++)
+    a.v[i] |= b.v[i];
+  return a;
+}
+
+template <int K> inline s16x8 shl(s16x8 v) {
+  for (int i = 0; i < 8; i++)
+    v.v[i] = static_cast<int16_t>(static_cast<uint16_t>(v.v[i]) << K);
+  return v;
+}
+template <int K> inline s16x8 shr(s16x8 v) {
+  for (int i = 0; i < 8; i++)
+    v.v[i] = static_cast<int16_t>(static_cast<uint16_t>(v.v[i]) >> K);
+  return v;
+}
+
+#endif
+
+} // namespace simd
+} // namespace logger
+} // namespace vexmaps
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Where LogSession writes its packets
+ *
+ * Sinks take bytes and only have to push them out on flush(), so several
+ * packets can go out in one system call. LogSession flushes after every frame
+ * unless told otherwise.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <span>
+#include <unistd.h>
+
+namespace vexmaps {
+namespace logger {
+
+class Sink {
+public:
+  /**
+   * @brief Queues data, which may already be written out
+   *
+   * @return false if the data could not be written
+   */
+  virtual bool write(std::span<const char> data) = 0;
+
+  /**
+   * @brief Writes out everything queued
+   */
+  virtual bool flush() = 0;
+
+  virtual ~Sink() = default;
+};
+
+/**
+ * @brief Writes to an iostream, e.g. std::cout
+ */
+class OstreamSink : public Sink {
+private:
+  std::ostream &out;
+
+public:
+  OstreamSink(std::ostream &out) : out(out) {}
+
+  bool write(std::span<const char> data) override {
+    out.write(data.data(), data.size());
+    return out.good();
+  }
+
+  bool flush() override {
+    out.flush();
+    return out.good();
+  }
+
+  ~OstreamSink() override = default;
+};
+
+/**
+ * @brief Writes straight to a file descriptor with write(2), skipping the
+ * formatting and locking of iostreams.
+ *
+ * Small writes are gathered in a staging buffer until flush() or until it is
+ * full, writes larger than half of it go out directly. On the brain
+ * STDOUT_FILENO is the PROS "sout" serial stream.
+ */
+class FdSink : public Sink {
+public:
+  static constexpr size_t default_capacity = 16 * 1024;
+  // cache line, so copies into the buffer and the DMA out of it stay aligned
+  static constexpr size_t alignment = 64;
+
+private:
+  int fd;
+  std::unique_ptr<char[], void (*)(char *)> staging;
+  size_t capacity;
+  size_t used = 0;
+
+  uint32_t errors = 0;
+
+  static char *allocate(size_t size) {
+    return static_cast<char *>(
+        ::operator new[](size, std::align_val_t{alignment}));
+  }
+
+  static void release(char *p) {
+    ::operator delete[](p, std::align_val_t{alignment});
+  }
+
+  // write(2) may take only part of the data, or be interrupted
+  bool writeAll(const char *data, size_t len) {
+    while (len > 0) {
+      ssize_t n = ::write(fd, data, len);
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        errors++;
+        return false;
+      }
+      data += n;
+      len -= n;
+    }
+    return true;
+  }
+
+public:
+  FdSink(int fd = STDOUT_FILENO, size_t capacity = default_capacity)
+      : fd(fd), staging(allocate(capacity), release), capacity(capacity) {}
+
+  FdSink(const FdSink &) = delete;
+  FdSink &operator=(const FdSink &) = delete;
+
+  bool write(std::span<const char> data) override {
+    if (data.size() > capacity / 2) {
+      // whatever is staged has to go out first to keep the order
+      if (used > 0 && !flush())
+        return false;
+      return writeAll(data.data(), data.size());
+    }
+    if (used + data.size() > capacity && !flush())
+      return false;
+    std::memcpy(staging.get() + used, data.data(), data.size());
+    used += data.size();
+    return true;
+  }
+
+  bool flush() override {
+    size_t len = used;
+    used = 0;
+    return writeAll(staging.get(), len);
+  }
+
+  /**
+   * @brief Writes that failed, the data of a failed write is dropped
+   */
+  uint32_t writeErrors() const { return errors; }
+
+  ~FdSink() override { flush(); }
+};
+
+} // namespace logger
+} // namespace vexmaps
@@ -0,0 +1,231 @@
+/**
+ * @file
+ * @brief Stream VByte style group varints for 16 bit particle deltas
+ *
+ * Values are zigzag encoded and stored in one or two bytes. The lengths go in
+ * a separate control stream, one bit per value, so 8 values share a control
+ * byte and the data bytes are packed back to back:
+ *
+ * [control bytes, (n + 7) / 8][data bytes, n to 2n]
+ *
+ * Bit i of control byte k is set when value 8k + i takes two bytes. Knowing a
+ * control byte is enough to (un)pack its 8 values with a single byte shuffle.
+ */
+
+#pragma once
+
+#include "simd.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace vexmaps {
+namespace logger {
+namespace stream_vbyte {
+
+// encode kernels store a full 16 byte vector per group, so the output must
+// have this much room past max_size()
+constexpr size_t slack = 16;
+
+constexpr size_t control_size(size_t n) { return (n + 7) / 8; }
+
+constexpr size_t max_size(size_t n) { return control_size(n) + 2 * n; }
+
+namespace detail {
+
+using Shuffle = std::array<uint8_t, 16>;
+
+// moves the used bytes of 8 little endian uint16s to the front
+constexpr std::array<Shuffle, 256> make_encode_shuffles() {
+  std::array<Shuffle, 256> table{};
+  for (int control = 0; control < 256; control++) {
+    Shuffle shuffle{};
+    shuffle.fill(0xff);
+    int out = 0;
+    for (int i = 0; i < 8; i++) {
+      shuffle[out++] = 2 * i;
+      if (control & (1 << i))
+        shuffle[out++] = 2 * i + 1;
+    }
+    table[control] = shuffle;
+  }
+  return table;
+}
+
+// inverse of the encode shuffle, unused high bytes are zeroed (0xff)
+constexpr std::array<Shuffle, 256> make_decode_shuffles() {
+  std::array<Shuffle, 256> table{};
+  for (int control = 0; control < 256; control++) {
+    Shuffle shuffle{};
+    shuffle.fill(0xff);
+    int in = 0;
+    for (int i = 0; i < 8; i++) {
+      shuffle[2 * i] = in++;
+      if (control & (1 << i))
+        shuffle[2 * i + 1] = in++;
+    }
+    table[control] = shuffle;
+  }
+  return table;
+}
+
+inline constexpr std::array<Shuffle, 256> encode_shuffles =
+    make_encode_shuffles();
+inline constexpr std::array<Shuffle, 256> decode_shuffles =
+    make_decode_shuffles();
+
+inline uint16_t zigzag(int16_t v) {
+  return static_cast<uint16_t>((static_cast<uint16_t>(v) << 1) ^ (v >> 15));
+}
+
+inline int16_t unzigzag(uint16_t v) {
+  return static_cast<int16_t>((v >> 1) ^ -(v & 1));
+}
+
+// scalar handling of one group of up to 8 values
+inline uint8_t *encode_group(const int16_t *in, size_t count, uint8_t *control,
+                             uint8_t *data) {
+  uint8_t bits = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint16_t v = zigzag(in[i]);
+    *data++ = static_cast<uint8_t>(v);
+    if (v > 0xff) {
+      bits |= 1 << i;
+      *data++ = static_cast<uint8_t>(v >> 8);
+    }
+  }
+  *control = bits;
+  return data;
+}
+
+inline const uint8_t *decode_group(const uint8_t *data, size_t count,
+                                   uint8_t control, int16_t *out) {
+  for (size_t i = 0; i < count; i++) {
+    uint16_t v = *data++;
+    if (control & (1 << i))
+      v |= static_cast<uint16_t>(*data++) << 8;
+    out[i] = unzigzag(v);
+  }
+  return data;
+}
+
+} // namespace detail
+
+/**
+ * @brief Encodes n int16 values, returns the number of bytes written
+ *
+ * @param out needs max_size(n) + slack bytes of room
+ */
+inline size_t encode(const int16_t *in, size_t n, uint8_t *out) {
+  uint8_t *control = out;
+  uint8_t *data = out + control_size(n);
+
+  const size_t full_groups = n / 8;
+  size_t group = 0;
+
+#if defined(VEXLOG_SIMD_BACKEND_NEON)
+  static const uint16_t bit_weights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+  const uint16x8_t vweights = vld1q_u16(bit_weights);
+  const uint16x8_t vbyte_max = vdupq_n_u16(0xff);
+
+  for (; group < full_groups; group++) {
+    int16x8_t v = vld1q_s16(in + 8 * group);
+    uint16x8_t zz = vreinterpretq_u16_s16(
+        veorq_s16(vshlq_n_s16(v, 1), vshrq_n_s16(v, 15)));
+
+    // one bit per lane that needs two bytes, summed into the control byte
+    uint16x8_t bits = vandq_u16(vcgtq_u16(zz, vbyte_max), vweights);
+    uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(bits));
+    uint8_t bits_byte =
+        static_cast<uint8_t>(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+
+    // cortex-a9 only has the 64 bit table lookups, so shuffle in two halves
+    uint8x16_t bytes = vreinterpretq_u8_u16(zz);
+    uint8x8x2_t table = {{vget_low_u8(bytes), vget_high_u8(bytes)}};
+    const uint8_t *shuffle = detail::encode_shuffles[bits_byte].data();
+    vst1_u8(data, vtbl2_u8(table, vld1_u8(shuffle)));
+    vst1_u8(data + 8, vtbl2_u8(table, vld1_u8(shuffle + 8)));
+
+    control[group] = bits_byte;
+    data += 8 + std::popcount(bits_byte);
+  }
+#elif defined(VEXLOG_SIMD_BACKEND_SSE)
+  for (; group < full_groups; group++) {
+    __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 8 * group));
+    __m128i zz = _mm_xor_si128(_mm_slli_epi16(v, 1), _mm_srai_epi16(v, 15));
+
+    __m128i small =
+        _mm_cmpeq_epi16(_mm_srli_epi16(zz, 8), _mm_setzero_si128());
+    uint8_t bits_byte = static_cast<uint8_t>(
+        ~_mm_movemask_epi8(_mm_packs_epi16(small, small)));
+
+    __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        detail::encode_shuffles[bits_byte].data()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(data),
+                     _mm_shuffle_epi8(zz, shuffle));
+
+    control[group] = bits_byte;
+    data += 8 + std::popcount(bits_byte);
+  }
+#endif
+
+  for (; group < control_size(n); group++) {
+    size_t count = std::min<size_t>(8, n - 8 * group);
+    data = detail::encode_group(in + 8 * group, count, control + group, data);
+  }
+
+  return data - out;
+}
+
+/**
+ * @brief Number of bytes encode() will write for the same values
+ */
+inline size_t encoded_size(const int16_t *in, size_t n) {
+  size_t len = control_size(n) + n;
+  for (size_t i = 0; i < n; i++)
+    len += detail::zigzag(in[i]) > 0xff;
+  return len;
+}
+
+/**
+ * @brief Decodes n int16 values, returns the number of bytes consumed
+ */
+inline size_t decode(const uint8_t *in, size_t n, int16_t *out) {
+  const uint8_t *control = in;
+  const uint8_t *data = in + control_size(n);
+
+  size_t group = 0;
+
+#if defined(VEXLOG_SIMD_BACKEND_SSE)
+  // a group uses at least 8 bytes, so a 16 byte load stays inside the input
+  // as long as another full group follows
+  const __m128i one = _mm_set1_epi16(1);
+  for (; 8 * group + 16 <= n; group++) {
+    uint8_t bits_byte = control[group];
+    __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        detail::decode_shuffles[bits_byte].data()));
+    __m128i zz = _mm_shuffle_epi8(packed, shuffle);
+
+    __m128i sign = _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(zz, one));
+    __m128i v = _mm_xor_si128(_mm_srli_epi16(zz, 1), sign);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8 * group), v);
+
+    data += 8 + std::popcount(bits_byte);
+  }
+#endif
+  // decoding happens on the host, the robot only needs the scalar version
+
+  for (; group < control_size(n); group++) {
+    size_t count = std::min<size_t>(8, n - 8 * group);
+    data = detail::decode_group(data, count, control[group], out + 8 * group);
+  }
+
+  return data - in;
+}
+
+} // namespace stream_vbyte
+} // namespace logger
+} // namespace vexmaps
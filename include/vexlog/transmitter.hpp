@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @brief Sink that queues packets and sends them a slice at a time, so a
+ * large frame never holds up the control loop
+ */
+
+#pragma once
+
+#include "platform.hpp"
+#include "sink.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <unistd.h>
+
+namespace vexmaps {
+namespace logger {
+
+/**
+ * @brief write(2) loop of the transmitters. front() returns the queued bytes
+ * that can be written in one go (empty once the queue is), consume(n) drops
+ * the n that were written. Stops once max_bytes were sent, max_micros passed
+ * (0 for no limit), the port is full or the queue is empty
+ *
+ * @param failed set if a write failed for another reason than a full port
+ * @return bytes sent
+ */
+template <typename Front, typename Consume>
+size_t pump_fd(int fd, size_t max_bytes, uint32_t max_micros, Front &&front,
+               Consume &&consume, bool &failed) {
+  const uint64_t start = platform::micros();
+  size_t sent = 0;
+  failed = false;
+  while (sent < max_bytes) {
+    std::span<const char> bytes = front();
+    if (bytes.empty())
+      break;
+
+    size_t len = std::min(bytes.size(), max_bytes - sent);
+    ssize_t n = ::write(fd, bytes.data(), len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      failed = n < 0 && errno != EAGAIN && errno != EWOULDBLOCK;
+      break;
+    }
+    consume(static_cast<size_t>(n));
+    sent += n;
+
+    if (max_micros != 0 && platform::micros() - start >= max_micros)
+      break;
+  }
+  return sent;
+}
+
+/**
+ * @brief Transmit queue drained by pump().
+ *
+ * write() only copies the data into a ring buffer, every pump() call then
+ * sends at most a given number of bytes or for at most a given time. Use it
+ * as the sink of a LogSession and call pump() from the control loop or a low
+ * priority task. One task may write and another pump at the same time.
+ *
+ * Writes are all or nothing: data that does not fit in the queue is dropped
+ * as a whole, so receivers only ever see whole packets. With a non-blocking
+ * fd (see setNonBlocking) pump() never waits on the port, with a blocking one
+ * the byte limit bounds how long it can wait.
+ */
+class ChunkedTransmitter : public Sink {
+public:
+  static constexpr size_t default_capacity = 64 * 1024;
+
+private:
+  int fd;
+  std::unique_ptr<char[]> ring;
+  size_t capacity;
+  // monotonic counters, only the difference matters
+  std::atomic<size_t> head{0};
+  std::atomic<size_t> tail{0};
+
+  std::atomic<uint32_t> dropped_writes{0};
+  std::atomic<uint32_t> errors{0};
+
+public:
+  ChunkedTransmitter(int fd = STDOUT_FILENO,
+                     size_t capacity = default_capacity)
+      : fd(fd), ring(std::make_unique<char[]>(capacity)), capacity(capacity) {
+  }
+
+  ChunkedTransmitter(const ChunkedTransmitter &) = delete;
+  ChunkedTransmitter &operator=(const ChunkedTransmitter &) = delete;
+
+  /**
+   * @brief Makes the fd non-blocking, so pump() returns as soon as the port
+   * is full
+   */
+  bool setNonBlocking() { return platform::setNonBlocking(fd); }
+
+  bool write(std::span<const char> data) override {
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t h = head.load(std::memory_order_acquire);
+    if (data.size() > capacity - (t - h)) {
+      dropped_writes.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    size_t offset = t % capacity;
+    size_t first = std::min(data.size(), capacity - offset);
+    std::memcpy(ring.get() + offset, data.data(), first);
+    std::memcpy(ring.get(), data.data() + first, data.size() - first);
+    tail.store(t + data.size(), std::memory_order_release);
+    return true;
+  }
+
+  // sending is up to pump()
+  bool flush() override { return true; }
+
+  /**
+   * @brief Sends queued bytes until max_bytes were sent, max_micros passed
+   * (0 for no limit), the port is full or the queue is empty
+   *
+   * @return bytes sent
+   */
+  size_t pump(size_t max_bytes, uint32_t max_micros = 0) {
+    bool failed;
+    size_t sent = pump_fd(
+        fd, max_bytes, max_micros,
+        [&]() -> std::span<const char> {
+          size_t h = head.load(std::memory_order_relaxed);
+          size_t t = tail.load(std::memory_order_acquire);
+          size_t offset = h % capacity;
+          return {ring.get() + offset, std::min(t - h, capacity - offset)};
+        },
+        [&](size_t n) {
+          head.store(head.load(std::memory_order_relaxed) + n,
+                     std::memory_order_release);
+        },
+        failed);
+    if (failed)
+      errors.fetch_add(1, std::memory_order_relaxed);
+    return sent;
+  }
+
+  /**
+   * @brief Bytes waiting to be sent, callers can skip producing frames while
+   * this is high
+   */
+  size_t backlog() const {
+    return tail.load(std::memory_order_acquire) -
+           head.load(std::memory_order_acquire);
+  }
+
+  size_t getCapacity() const { return capacity; }
+
+  /**
+   * @brief Writes dropped because the queue was full
+   */
+  uint32_t droppedWrites() const { return dropped_writes.load(); }
+
+  /**
+   * @brief Failed write(2) calls other than a full port
+   */
+  uint32_t writeErrors() const { return errors.load(); }
+
+  ~ChunkedTransmitter() override = default;
+};
+
+} // namespace logger
+} // namespace vexmaps
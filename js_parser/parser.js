@@ -22,6 +22,332 @@ function readVarInt(buffer) {
     return (value & 1) ? ~res : res;
 }
 
+// stream vbyte groups used by the 0x4a particle logger
+// [control bytes, (n + 7) / 8][data bytes], bit i of control byte k is set
+// when value 8k + i is two bytes long. Values are zigzag encoded int16s
+function readStreamVByte16(buffer, offset, n) {
+    const values = new Int16Array(n);
+    let control = offset;
+    let data = offset + ((n + 7) >> 3);
+
+    for (let i = 0; i < n; i++) {
+        let value = buffer[data++];
+        if (buffer[control + (i >> 3)] & (1 << (i & 7))) {
+            value |= buffer[data++] << 8;
+        }
+        values[i] = (value >> 1) ^ -(value & 1);
+    }
+    return { values: values, length: data - offset };
+}
+
+// bit packed blocks used by the 0x4d particle logger, see bitpack.hpp
+// [width][reference, int16 LE][packed values] per block of 128. Full blocks
+// put value i in lane i % 8 of row i / 8, with the rows packed into width
+// vectors of 8 16 bit lanes. The last partial block is packed LSB first
+function readBitPacked16(buffer, offset, n) {
+    const values = new Int16Array(n);
+    let i = offset;
+    for (let block = 0; block < n; block += 128) {
+        const count = Math.min(128, n - block);
+        const width = Math.min(buffer[i], 16);
+        const reference = (buffer[i + 1] | (buffer[i + 2] << 8)) << 16 >> 16;
+        const mask = (1 << width) - 1;
+        i += 3;
+
+        if (count === 128) {
+            // bit b of lane l is bit (b % 16) of the lane in vector b / 16
+            for (let k = 0; k < 128; k++) {
+                const lane = k & 7;
+                const bit = (k >> 3) * width;
+                const word = i + 16 * (bit >> 4) + 2 * lane;
+                let value = (buffer[word] | (buffer[word + 1] << 8)) >>> (bit & 15);
+                if ((bit & 15) + width > 16) {
+                    value |= (buffer[word + 16] | (buffer[word + 17] << 8)) << (16 - (bit & 15));
+                }
+                values[block + k] = reference + (value & mask);
+            }
+            i += 16 * width;
+        } else {
+            let bitBuffer = 0;
+            let bitCount = 0;
+            let data = i;
+            for (let k = 0; k < count; k++) {
+                while (bitCount < width) {
+                    bitBuffer |= buffer[data++] << bitCount;
+                    bitCount += 8;
+                }
+                values[block + k] = reference + (bitBuffer & mask);
+                bitBuffer >>>= width;
+                bitCount -= width;
+            }
+            i += (count * width + 7) >> 3;
+        }
+    }
+    return { values: values, length: i - offset };
+}
+
+// same as readVarUInt, starting at offset and also returning the length
+function readVarUIntAt(buffer, offset) {
+    let value = 0;
+    let length = 0;
+    let currentByte;
+
+    do {
+        currentByte = buffer[offset + length];
+        value |= (currentByte & 0x7F) << (length * 7);
+        length += 1;
+    } while (currentByte & 0x80);
+    return { value: value >>> 0, length: length };
+}
+
+// n zigzagged int16 varints
+function readVarInt16Array(buffer, offset, n) {
+    const values = new Int16Array(n);
+    let i = offset;
+    for (let k = 0; k < n; k++) {
+        const v = readVarUIntAt(buffer, i);
+        values[k] = (v.value >>> 1) ^ -(v.value & 1);
+        i += v.length;
+    }
+    return { values: values, length: i - offset };
+}
+
+const TEMPORAL_FLAG_KEYFRAME = 1 << 0;
+const TEMPORAL_FLAG_PARENTS = 1 << 1;
+const TEMPORAL_SUBDIVISIONS = 8;
+
+// decodes the 0x4b particle logger, which needs the previous generation.
+// Returns null until a keyframe has been seen, or after a generation was lost
+class TemporalParticlesDecoder {
+    constructor() {
+        this.x = null;
+        this.y = null;
+        this.framesSinceKeyframe = 0;
+        this.synced = false;
+    }
+
+    // payload is what follows the magics and the length
+    decode(payload) {
+        const view = new DataView(payload.buffer, payload.byteOffset, payload.byteLength);
+        let i = 0;
+        const flags = payload[i++];
+        let v = readVarUIntAt(payload, i);
+        const n = v.value;
+        i += v.length;
+        v = readVarUIntAt(payload, i);
+        const framesSinceKeyframe = v.value;
+        i += v.length;
+        const weightMin = view.getFloat32(i, true);
+        const weightMax = view.getFloat32(i + 4, true);
+        i += 8;
+        v = readVarUIntAt(payload, i);
+        const weightsMod = v.value;
+        i += v.length;
+
+        const keyframe = (flags & TEMPORAL_FLAG_KEYFRAME) !== 0;
+        let xShift = 0;
+        let yShift = 0;
+        if (keyframe) {
+            this.xOrigin = view.getFloat32(i, true);
+            this.yOrigin = view.getFloat32(i + 4, true);
+            this.step = view.getFloat32(i + 8, true);
+            i += 12;
+            this.synced = true;
+        } else {
+            if (!this.synced || framesSinceKeyframe !== this.framesSinceKeyframe + 1) {
+                this.synced = false;
+                return null;
+            }
+            v = readVarUIntAt(payload, i);
+            xShift = (v.value >>> 1) ^ -(v.value & 1);
+            i += v.length;
+            v = readVarUIntAt(payload, i);
+            yShift = (v.value >>> 1) ^ -(v.value & 1);
+            i += v.length;
+        }
+        this.framesSinceKeyframe = framesSinceKeyframe;
+
+        let parents = null;
+        if (flags & TEMPORAL_FLAG_PARENTS) {
+            const r = readVarInt16Array(payload, i, n);
+            i += r.length;
+            parents = new Uint16Array(n);
+            let last = 0;
+            for (let k = 0; k < n; k++) {
+                last = (last + r.values[k]) & 0xFFFF;
+                parents[k] = last;
+            }
+        }
+
+        const rx = readVarInt16Array(payload, i, n);
+        i += rx.length;
+        const ry = readVarInt16Array(payload, i, n);
+        i += ry.length;
+        const rw = readVarInt16Array(payload, i, n);
+        i += rw.length;
+
+        // positions in subdivisions of a step, int16 so they wrap the same
+        // way as on the robot
+        const px = new Int16Array(n);
+        const py = new Int16Array(n);
+        let lastX = 0;
+        let lastY = 0;
+        for (let k = 0; k < n; k++) {
+            if (keyframe) {
+                lastX = (lastX + rx.values[k]) << 16 >> 16;
+                lastY = (lastY + ry.values[k]) << 16 >> 16;
+                px[k] = TEMPORAL_SUBDIVISIONS * lastX;
+                py[k] = TEMPORAL_SUBDIVISIONS * lastY;
+            } else {
+                const p = parents ? parents[k] : k;
+                px[k] = this.x[p] + xShift + TEMPORAL_SUBDIVISIONS * rx.values[k];
+                py[k] = this.y[p] + yShift + TEMPORAL_SUBDIVISIONS * ry.values[k];
+            }
+        }
+        this.x = px;
+        this.y = py;
+
+        const fine = this.step / TEMPORAL_SUBDIVISIONS;
+        const x = new Float32Array(n);
+        const y = new Float32Array(n);
+        const weights = new Float32Array(n);
+        let w = 0;
+        for (let k = 0; k < n; k++) {
+            x[k] = this.xOrigin + px[k] * fine;
+            y[k] = this.yOrigin + py[k] * fine;
+            w = (w + rw.values[k]) << 16 >> 16;
+            weights[k] = weightMin + w * (weightMax - weightMin) / weightsMod;
+        }
+        return { x: x, y: y, weights: weights, length: i };
+    }
+}
+
+// decodes the 0x4e particle logger, payload is what follows the magics and
+// the length. Unique particles come with repeat counts, with expand they are
+// repeated back into all N particles
+function readDedupParticles(payload, expand) {
+    const view = new DataView(payload.buffer, payload.byteOffset, payload.byteLength);
+    let i = 0;
+    const bounds = [];
+    for (let k = 0; k < 3; k++) {
+        const min = view.getFloat32(i, true);
+        const max = view.getFloat32(i + 4, true);
+        i += 8;
+        const v = readVarUIntAt(payload, i);
+        i += v.length;
+        bounds.push({ min: min, step: v.value ? (max - min) / v.value : 0 });
+    }
+    let v = readVarUIntAt(payload, i);
+    const n = v.value;
+    i += v.length;
+    v = readVarUIntAt(payload, i);
+    const unique = v.value;
+    i += v.length;
+
+    const fields = [];
+    for (let k = 0; k < 3; k++) {
+        const r = readVarInt16Array(payload, i, unique);
+        i += r.length;
+        const values = new Float32Array(unique);
+        let last = 0;
+        for (let u = 0; u < unique; u++) {
+            last = (last + r.values[u]) << 16 >> 16;
+            values[u] = bounds[k].min + last * bounds[k].step;
+        }
+        fields.push(values);
+    }
+    const counts = new Uint32Array(unique);
+    for (let u = 0; u < unique; u++) {
+        v = readVarUIntAt(payload, i);
+        counts[u] = v.value;
+        i += v.length;
+    }
+
+    if (!expand) {
+        return { x: fields[0], y: fields[1], weights: fields[2], counts: counts, length: i };
+    }
+    const x = new Float32Array(n);
+    const y = new Float32Array(n);
+    const weights = new Float32Array(n);
+    let k = 0;
+    for (let u = 0; u < unique && k < n; u++) {
+        const end = Math.min(k + counts[u], n);
+        x.fill(fields[0][u], k, end);
+        y.fill(fields[1][u], k, end);
+        weights.fill(fields[2][u], k, end);
+        k = end;
+    }
+    return { x: x, y: y, weights: weights, length: i };
+}
+
+// rans coded int16s used by the 0x4c particle logger, see rans.hpp
+// (token count)(frequencies)(rans size)[rans bytes](extra size)[extra bits]
+const RANS_SCALE_BITS = 11;
+const RANS_STATE_COUNT = 4;
+const RANS_STATE_LOW = 1 << 15;
+
+function readRans16(buffer, offset, n) {
+    let i = offset;
+    let v = readVarUIntAt(buffer, i);
+    const used = Math.min(v.value, 28);
+    i += v.length;
+
+    // slot -> token | frequency << 5 | offset of the slot in the token << 18
+    const table = new Uint32Array(1 << RANS_SCALE_BITS);
+    let start = 0;
+    for (let s = 0; s < used; s++) {
+        v = readVarUIntAt(buffer, i);
+        i += v.length;
+        for (let k = 0; k < v.value && start + k < table.length; k++) {
+            table[start + k] = s | (v.value << 5) | (k << 18);
+        }
+        start += v.value;
+    }
+
+    v = readVarUIntAt(buffer, i);
+    i += v.length;
+    let ptr = i;
+    const extraSize = readVarUIntAt(buffer, i + v.value);
+    let extra = i + v.value + extraSize.length;
+    const end = extra + extraSize.value;
+
+    // value k uses state k % 4, renormalized with little endian 16 bit words
+    const states = new Uint32Array(RANS_STATE_COUNT);
+    for (let s = 0; s < RANS_STATE_COUNT; s++) {
+        states[s] = buffer[ptr] | (buffer[ptr + 1] << 8) | (buffer[ptr + 2] << 16) | (buffer[ptr + 3] << 24);
+        ptr += 4;
+    }
+
+    const values = new Int16Array(n);
+    let bitBuffer = 0;
+    let bitCount = 0;
+    const mask = (1 << RANS_SCALE_BITS) - 1;
+    for (let k = 0; k < n; k++) {
+        let x = states[k % RANS_STATE_COUNT];
+        const entry = table[x & mask];
+        const t = entry & 31;
+        x = ((entry >>> 5) & 0x1FFF) * (x >>> RANS_SCALE_BITS) + (entry >>> 18);
+        if (x < RANS_STATE_LOW) {
+            x = (x << 16) | buffer[ptr] | (buffer[ptr + 1] << 8);
+            ptr += 2;
+        }
+        states[k % RANS_STATE_COUNT] = x;
+
+        let value = t;
+        if (t >= 16) {
+            const bits = t - 12;
+            while (bitCount < bits) {
+                bitBuffer |= buffer[extra++] << bitCount;
+                bitCount += 8;
+            }
+            value = (1 << bits) | (bitBuffer & ((1 << bits) - 1));
+            bitBuffer >>>= bits;
+            bitCount -= bits;
+        }
+        values[k] = (value >>> 1) ^ -(value & 1);
+    }
+    return { values: values, length: end - offset };
+}
 
 // https://stackoverflow.com/questions/5678432/decompressing-half-precision-floats-in-javascript#8796597
 function decodeFloat16 (binary) {"use strict";
@@ -38,6 +364,329 @@ function decodeFloat16 (binary) {"use strict";
     );
 };
 
+// decodes one lz4 block from src[srcOffset, srcEnd) into dst at dstOffset.
+// Matches can reach back into whatever is already in dst before dstOffset,
+// which is how streamed frames use the history of previous ones
+function lz4DecompressBlock(src, srcOffset, srcEnd, dst, dstOffset) {
+    let s = srcOffset;
+    let d = dstOffset;
+
+    while (s < srcEnd) {
+        const token = src[s++];
+
+        let literals = token >> 4;
+        if (literals === 15) {
+            let b;
+            do {
+                b = src[s++];
+                literals += b;
+            } while (b === 255);
+        }
+        dst.set(src.subarray(s, s + literals), d);
+        s += literals;
+        d += literals;
+
+        // the last sequence only has literals
+        if (s >= srcEnd) break;
+
+        const offset = src[s] | (src[s + 1] << 8);
+        s += 2;
+        let matchLength = (token & 15) + 4;
+        if ((token & 15) === 15) {
+            let b;
+            do {
+                b = src[s++];
+                matchLength += b;
+            } while (b === 255);
+        }
+        // byte by byte since matches can overlap the bytes being written
+        let m = d - offset;
+        for (let i = 0; i < matchLength; i++) {
+            dst[d++] = dst[m++];
+        }
+    }
+    return d;
+}
+
+const FRAME_FLAG_STREAM = 1 << 0;
+const FRAME_FLAG_RESET = 1 << 1;
+const FRAME_FLAG_DICTIONARY = 1 << 2;
+const FRAME_MAX_HISTORY = 64 * 1024;
+
+// upper 4 bits of the flags, lz4hc blocks are decoded like lz4 ones
+const CODEC_NONE = 0;
+const CODEC_LZ4 = 1;
+const CODEC_LZ4HC = 2;
+
+// decodes frames written by LogSession:
+// [flags][dictionary id, only with the dictionary flag](raw size)[block]
+// streamed frames are skipped until the next reset point
+class FrameDecoder {
+    constructor() {
+        this.history = new Uint8Array(2 * FRAME_MAX_HISTORY);
+        this.historyOffset = 0;
+        this.synced = false;
+        this.skippedFrames = 0;
+        this.unknownDictionaryFrames = 0;
+        this.unknownCodecFrames = 0;
+        this.dictionaries = new Map();
+    }
+
+    // dictionary is a Uint8Array, e.g. the dictionary.bin next to this file
+    addDictionary(id, dictionary) {
+        this.dictionaries.set(id >>> 0, dictionary);
+    }
+
+    // a packet went missing, streamed frames wait for the next reset
+    frameLost() {
+        this.synced = false;
+    }
+
+    // frame is a Uint8Array, returns the serialized message or null
+    decode(frame) {
+        const flags = frame[0];
+        let i = 1;
+
+        let dictionary = null;
+        if (flags & FRAME_FLAG_DICTIONARY) {
+            const id = (frame[i] | (frame[i + 1] << 8) | (frame[i + 2] << 16) | (frame[i + 3] << 24)) >>> 0;
+            i += 4;
+            dictionary = this.dictionaries.get(id);
+            if (!dictionary) {
+                // decoding with the wrong dictionary would only produce garbage
+                this.unknownDictionaryFrames++;
+                if (flags & FRAME_FLAG_STREAM) this.synced = false;
+                return null;
+            }
+        }
+
+        let rawSize = 0;
+        for (let shift = 0; ; shift += 7) {
+            const b = frame[i++];
+            rawSize |= (b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+        }
+
+        const codec = flags >> 4;
+        if (codec !== CODEC_NONE && codec !== CODEC_LZ4 && codec !== CODEC_LZ4HC) {
+            this.unknownCodecFrames++;
+            if (flags & FRAME_FLAG_STREAM) this.synced = false;
+            return null;
+        }
+        // raw blocks are decoded by copying them
+        const decodeBlock = codec === CODEC_NONE
+            ? (dst, offset) => {
+                if (frame.length - i !== rawSize) return -1;
+                dst.set(frame.subarray(i), offset);
+                return offset + frame.length - i;
+            }
+            : (dst, offset) => lz4DecompressBlock(frame, i, frame.length, dst, offset);
+
+        if (!(flags & FRAME_FLAG_STREAM)) {
+            // the dictionary goes right before the output so matches can
+            // reach into it
+            const prefix = dictionary ? dictionary.length : 0;
+            const out = new Uint8Array(prefix + rawSize);
+            if (dictionary) out.set(dictionary, 0);
+            if (decodeBlock(out, prefix) - prefix !== rawSize) return null;
+            return out.subarray(prefix);
+        }
+
+        if (flags & FRAME_FLAG_RESET) {
+            this.historyOffset = 0;
+            if (dictionary) {
+                this.history.set(dictionary, 0);
+                this.historyOffset = dictionary.length;
+            }
+            this.synced = true;
+        } else if (!this.synced) {
+            this.skippedFrames++;
+            return null;
+        }
+
+        // keep the last 64KB as history when running out of room
+        if (this.historyOffset + rawSize > this.history.length) {
+            const keep = Math.min(this.historyOffset, FRAME_MAX_HISTORY);
+            let target = this.history;
+            if (keep + rawSize > this.history.length) {
+                target = new Uint8Array(Math.max(2 * this.history.length, keep + rawSize));
+            }
+            target.set(this.history.subarray(this.historyOffset - keep, this.historyOffset), 0);
+            this.history = target;
+            this.historyOffset = keep;
+        }
+
+        const start = this.historyOffset;
+        const end = decodeBlock(this.history, start);
+        if (end - start !== rawSize) {
+            this.synced = false;
+            this.skippedFrames++;
+            return null;
+        }
+        this.historyOffset = end;
+        return this.history.slice(start, end);
+    }
+}
+
+const XXH_PRIME32_1 = 0x9E3779B1;
+const XXH_PRIME32_2 = 0x85EBCA77;
+const XXH_PRIME32_3 = 0xC2B2AE3D;
+const XXH_PRIME32_4 = 0x27D4EB2F;
+const XXH_PRIME32_5 = 0x165667B1;
+
+function rotl32(x, r) {
+    return (x << r) | (x >>> (32 - r));
+}
+
+// xxHash32 of buffer[start, end) with seed 0
+function xxh32(buffer, start, end) {
+    const read32 = (i) => (buffer[i] | (buffer[i + 1] << 8) | (buffer[i + 2] << 16) | (buffer[i + 3] << 24));
+    const round = (acc, input) => Math.imul(rotl32((acc + Math.imul(input, XXH_PRIME32_2)) | 0, 13), XXH_PRIME32_1);
+    let i = start;
+    let h;
+    if (end - start >= 16) {
+        let v1 = (XXH_PRIME32_1 + XXH_PRIME32_2) | 0;
+        let v2 = XXH_PRIME32_2;
+        let v3 = 0;
+        let v4 = -XXH_PRIME32_1 | 0;
+        for (; i + 16 <= end; i += 16) {
+            v1 = round(v1, read32(i));
+            v2 = round(v2, read32(i + 4));
+            v3 = round(v3, read32(i + 8));
+            v4 = round(v4, read32(i + 12));
+        }
+        h = (rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18)) | 0;
+    } else {
+        h = XXH_PRIME32_5;
+    }
+    h = (h + end - start) | 0;
+    for (; i + 4 <= end; i += 4) {
+        h = Math.imul(rotl32((h + Math.imul(read32(i), XXH_PRIME32_3)) | 0, 17), XXH_PRIME32_4);
+    }
+    for (; i < end; i++) {
+        h = Math.imul(rotl32((h + Math.imul(buffer[i], XXH_PRIME32_5)) | 0, 11), XXH_PRIME32_1);
+    }
+    h = Math.imul(h ^ (h >>> 15), XXH_PRIME32_2);
+    h = Math.imul(h ^ (h >>> 13), XXH_PRIME32_3);
+    return (h ^ (h >>> 16)) >>> 0;
+}
+
+const PACKET_SYNC1 = 0xA5;
+const PACKET_SYNC2 = 0x5A;
+// frame::bound(frame::max_raw_size), larger sizes are taken as corrupt
+const FRAME_MAX_RAW_SIZE = 128 * 1024;
+const PACKET_MAX_PAYLOAD = 10 + FRAME_MAX_RAW_SIZE + Math.floor(FRAME_MAX_RAW_SIZE / 255) + 16;
+
+// finds the packets written by LogSession in a byte stream:
+// [sync 1][sync 2](payload size)(sequence)[codec][header check][payload][xxhash32 LE]
+// where the header check is the low byte of the xxhash32 of size, sequence
+// and codec, so false sync words are rejected before waiting for a payload
+// push bytes as they arrive, next() returns
+// { sequence, codec, lost, payload } or null when more bytes are needed.
+// Bytes outside valid packets (text, corruption) are skipped
+class PacketDecoder {
+    constructor(maxPayload = PACKET_MAX_PAYLOAD) {
+        this.pending = new Uint8Array(0);
+        this.start = 0;
+        this.maxPayload = maxPayload;
+        this.lastSequence = -1;
+        this.receivedPackets = 0;
+        this.lostPackets = 0;
+        this.corruptPackets = 0;
+        this.skippedBytes = 0;
+    }
+
+    push(bytes) {
+        const rest = this.pending.subarray(this.start);
+        const merged = new Uint8Array(rest.length + bytes.length);
+        merged.set(rest, 0);
+        merged.set(bytes, rest.length);
+        this.pending = merged;
+        this.start = 0;
+    }
+
+    // moves start to the first sync word at or after from
+    skip(from) {
+        const buf = this.pending;
+        let i = from;
+        while (i < buf.length) {
+            i = buf.indexOf(PACKET_SYNC1, i);
+            if (i < 0) {
+                i = buf.length;
+                break;
+            }
+            // the second half may not have arrived yet
+            if (i + 1 === buf.length || buf[i + 1] === PACKET_SYNC2) break;
+            i++;
+        }
+        this.skippedBytes += i - this.start;
+        this.start = i;
+    }
+
+    next() {
+        const buf = this.pending;
+        while (true) {
+            this.skip(this.start);
+            if (buf.length - this.start < 2) return null;
+
+            let i = this.start + 2;
+            const fields = [];
+            let valid = true;
+            for (let k = 0; k < 2 && valid; k++) {
+                let value = 0;
+                let done = false;
+                for (let shift = 0; shift < 35 && i < buf.length; shift += 7) {
+                    const b = buf[i++];
+                    value += (b & 0x7F) * 2 ** shift;
+                    if (!(b & 0x80)) {
+                        done = true;
+                        break;
+                    }
+                }
+                if (!done) {
+                    // a sync word inside something else if the varint is too long
+                    if (i < buf.length) valid = false;
+                    else return null;
+                }
+                fields.push(value);
+            }
+            const size = fields[0];
+            if (!valid || size > this.maxPayload) {
+                this.skip(this.start + 1);
+                continue;
+            }
+            if (buf.length - i < 2) return null;
+            const codec = buf[i++];
+            if (buf[i] !== (xxh32(buf, this.start + 2, i) & 0xFF)) {
+                this.corruptPackets++;
+                this.skip(this.start + 1);
+                continue;
+            }
+            i++;
+            if (buf.length - i < size + 4) return null;
+
+            const end = i + size;
+            const expected = (buf[end] | (buf[end + 1] << 8) | (buf[end + 2] << 16) | (buf[end + 3] << 24)) >>> 0;
+            if (xxh32(buf, this.start + 2, end) !== expected) {
+                this.corruptPackets++;
+                this.skip(this.start + 1);
+                continue;
+            }
+
+            const sequence = fields[1] >>> 0;
+            let lost = 0;
+            // a jump backwards means the sender restarted
+            const gap = (sequence - this.lastSequence - 1) >>> 0;
+            if (this.lastSequence >= 0 && gap < 2 ** 31) lost = gap;
+            this.lostPackets += lost;
+            this.lastSequence = sequence;
+            this.receivedPackets++;
+            this.start = end + 4;
+            return { sequence: sequence, codec: codec, lost: lost, payload: buf.subarray(i, end) };
+        }
+    }
+}
+
 function readMagic(){
     buffer[0]
 }
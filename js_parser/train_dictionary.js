@@ -0,0 +1,215 @@
+// trains an LZ4 dictionary from recorded vexlog messages
+//
+// usage: node train_dictionary.js [--size bytes] <out.hpp> <out.bin> samples...
+//
+// every sample file holds uncompressed messages back to back (for example the
+// dump written by bin/host/vexlog, or frames decoded with FrameDecoder). Each
+// top level message is one training sample.
+//
+// The dictionary is built like zstd's COVER trainer: every 6 byte sequence is
+// scored by how many samples contain it, and the segments with the highest
+// score that are not covered yet are picked until the dictionary is full. The
+// best segments go last so they are closest to the data being compressed.
+
+const fs = require('fs');
+
+const DMER = 6;
+const SEGMENT = 64;
+
+// same as readVarUIntAt in parser.js
+function readVarUIntAt(buffer, offset) {
+    let value = 0;
+    let length = 0;
+    let currentByte;
+
+    do {
+        if (offset + length >= buffer.length || length >= 5) return null;
+        currentByte = buffer[offset + length];
+        value |= (currentByte & 0x7F) << (length * 7);
+        length += 1;
+    } while (currentByte & 0x80);
+    return { value: value >>> 0, length: length };
+}
+
+// [magic1][magic2](payload size)[payload]
+function splitMessages(buffer) {
+    const messages = [];
+    let offset = 0;
+    while (offset < buffer.length) {
+        const size = readVarUIntAt(buffer, offset + 2);
+        const end = size && offset + 2 + size.length + size.value;
+        if (!size || end > buffer.length) {
+            // not a message stream, use what is left as a single sample
+            messages.push(buffer.subarray(offset));
+            break;
+        }
+        messages.push(buffer.subarray(offset, end));
+        offset = end;
+    }
+    return messages;
+}
+
+function dmerKey(buffer, i) {
+    // 48 bits, still exact in a double
+    let key = 0;
+    for (let k = 0; k < DMER; k++) {
+        key = key * 256 + buffer[i + k];
+    }
+    return key;
+}
+
+function train(samples, size) {
+    let total = 0;
+    for (const sample of samples) total += sample.length;
+
+    // every sample back to back, dmers that cross a sample boundary get -1
+    const data = new Uint8Array(total);
+    const sampleEnd = new Int32Array(total);
+    let offset = 0;
+    for (const sample of samples) {
+        data.set(sample, offset);
+        sampleEnd.fill(offset + sample.length, offset, offset + sample.length);
+        offset += sample.length;
+    }
+
+    const ids = new Map();
+    const dmers = new Int32Array(total).fill(-1);
+    const counts = [];
+    const lastSample = [];
+    let sampleIndex = 0;
+    for (let i = 0; i < total; i++) {
+        if (i > 0 && sampleEnd[i] !== sampleEnd[i - 1]) sampleIndex++;
+        if (i + DMER > sampleEnd[i]) continue;
+
+        const key = dmerKey(data, i);
+        let id = ids.get(key);
+        if (id === undefined) {
+            id = counts.length;
+            ids.set(key, id);
+            counts.push(0);
+            lastSample.push(-1);
+        }
+        dmers[i] = id;
+        // count samples, not occurrences
+        if (lastSample[id] !== sampleIndex) {
+            lastSample[id] = sampleIndex;
+            counts[id]++;
+        }
+    }
+
+    const score = (i) => (dmers[i] < 0 ? 0 : counts[dmers[i]]);
+
+    const segments = [];
+    let used = 0;
+    while (used < size) {
+        const length = Math.min(SEGMENT, size - used);
+
+        // sliding window over every segment that stays inside its sample
+        let best = -1;
+        let bestScore = 0;
+        let windowScore = 0;
+        for (let i = 0; i < total; i++) {
+            windowScore += score(i);
+            const start = i - length + 1;
+            if (start < 0) continue;
+            if (start > 0) windowScore -= score(start - 1);
+            if (sampleEnd[start] === sampleEnd[i] && windowScore > bestScore) {
+                best = start;
+                bestScore = windowScore;
+            }
+        }
+        if (best < 0) break;
+
+        segments.push(data.subarray(best, best + length));
+        used += length;
+        // covered dmers are worth nothing to the next segments
+        for (let i = best; i < best + length; i++) {
+            if (dmers[i] >= 0) counts[dmers[i]] = 0;
+        }
+    }
+
+    const dictionary = new Uint8Array(used);
+    offset = used;
+    for (const segment of segments) {
+        offset -= segment.length;
+        dictionary.set(segment, offset);
+    }
+    return dictionary;
+}
+
+// FNV-1a, sent in every frame compressed with the dictionary
+function dictionaryId(dictionary) {
+    let hash = 0x811C9DC5;
+    for (const byte of dictionary) {
+        hash = Math.imul(hash ^ byte, 0x01000193) >>> 0;
+    }
+    return hash;
+}
+
+function header(dictionary, id) {
+    const lines = [];
+    for (let i = 0; i < dictionary.length; i += 12) {
+        const bytes = Array.from(dictionary.subarray(i, i + 12),
+            (b) => '0x' + b.toString(16).padStart(2, '0'));
+        lines.push('    ' + bytes.join(', ') + ',');
+    }
+
+    return `/**
+ * @file
+ * @brief LZ4 dictionary trained on recorded vexlog messages
+ *
+ * Generated by js_parser/train_dictionary.js, do not edit. Pass it to
+ * LogSession::setDictionary and FrameDecoder::addDictionary.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace vexmaps {
+namespace logger {
+namespace dictionary {
+
+constexpr uint32_t id = 0x${id.toString(16).padStart(8, '0')};
+
+inline constexpr unsigned char data[] = {
+${lines.join('\n')}
+};
+
+inline std::span<const char> bytes() {
+  return {reinterpret_cast<const char *>(data), sizeof(data)};
+}
+
+} // namespace dictionary
+} // namespace logger
+} // namespace vexmaps
+`;
+}
+
+function main(argv) {
+    let size = 4096;
+    const args = [];
+    for (let i = 0; i < argv.length; i++) {
+        if (argv[i] === '--size') size = parseInt(argv[++i]);
+        else args.push(argv[i]);
+    }
+    if (args.length < 3 || !(size > 0 && size <= 64 * 1024)) {
+        console.error('usage: node train_dictionary.js [--size bytes] <out.hpp> <out.bin> samples...');
+        process.exit(1);
+    }
+
+    const samples = [];
+    for (const path of args.slice(2)) {
+        samples.push(...splitMessages(fs.readFileSync(path)));
+    }
+
+    const dictionary = train(samples, size);
+    const id = dictionaryId(dictionary);
+    fs.writeFileSync(args[0], header(dictionary, id));
+    fs.writeFileSync(args[1], dictionary);
+    console.log(`${samples.length} samples, ${dictionary.length} byte dictionary, id 0x${id.toString(16)}`);
+}
+
+main(process.argv.slice(2));
@@ -9,6 +9,8 @@ const size_t N = 3072;
 
 vexmaps::logger::PFLogger<N> logger;
 
+// raw bytes on the serial port, frames carry their own sync word and checksum
+// (see packet.hpp)
 void initialize() { pros::c::serctl(SERCTL_DISABLE_COBS, NULL); }
 
 void disabled() {}
@@ -54,8 +56,6 @@ void opcontrol() {
 
   auto end_time = pros::micros();
 
-  // TODO: in practice the user should not have to specify a length since they
-  // likely dont know
   vexmaps::logger::sendData(&logger);
   std::cout << "input data time: " << end_time - start_time << std::endl;
 